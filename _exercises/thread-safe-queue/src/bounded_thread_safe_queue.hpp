@@ -0,0 +1,229 @@
+#ifndef BOUNDED_THREAD_SAFE_QUEUE_HPP
+#define BOUNDED_THREAD_SAFE_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "queue_status.hpp"
+
+// Fixed-capacity variant of ThreadSafeQueue - storage is preallocated once as a ring buffer
+// and push blocks while the queue is full (backpressure for fast producers)
+template <typename T>
+class BoundedThreadSafeQueue
+{
+    using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    std::unique_ptr<Slot[]> buffer_;
+    const size_t capacity_;
+    size_t head_{};
+    size_t size_{};
+    std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+    std::condition_variable cv_q_not_full_;
+    bool is_closed_{false};
+
+    T* slot(size_t index)
+    {
+        return reinterpret_cast<T*>(&buffer_[index]);
+    }
+
+    bool is_full() const
+    {
+        return size_ == capacity_;
+    }
+
+    void throw_if_closed() const
+    {
+        if (is_closed_)
+            throw QueueClosed{};
+    }
+
+    bool is_ready_to_pop() const
+    {
+        return size_ != 0 || is_closed_;
+    }
+
+    template <typename U>
+    void enqueue(U&& item)
+    {
+        size_t tail = (head_ + size_) % capacity_;
+        new (slot(tail)) T(std::forward<U>(item));
+        ++size_;
+    }
+
+    void dequeue(T& item)
+    {
+        T* front = slot(head_);
+        item = std::move(*front);
+        front->~T();
+        head_ = (head_ + 1) % capacity_;
+        --size_;
+    }
+
+    QueueStatus pop_front(std::unique_lock<std::mutex>& lk, T& item)
+    {
+        if (size_ == 0)
+            return QueueStatus::closed;
+
+        dequeue(item);
+        lk.unlock();
+        cv_q_not_full_.notify_one();
+
+        return QueueStatus::success;
+    }
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{mtx_q_};
+            cv_q_not_full_.wait(lk, [this] { return !is_full() || is_closed_; });
+            throw_if_closed();
+            enqueue(std::forward<U>(item));
+        }
+        cv_q_not_empty_.notify_one();
+    }
+
+    template <typename U>
+    bool try_push_item(U&& item)
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            throw_if_closed();
+
+            if (is_full())
+                return false;
+
+            enqueue(std::forward<U>(item));
+        }
+        cv_q_not_empty_.notify_one();
+
+        return true;
+    }
+
+public:
+    explicit BoundedThreadSafeQueue(size_t capacity)
+        : buffer_{new Slot[capacity]}, capacity_{capacity}
+    {
+        if (capacity_ == 0)
+            throw std::invalid_argument("BoundedThreadSafeQueue capacity must be greater than zero");
+    }
+
+    BoundedThreadSafeQueue(const BoundedThreadSafeQueue&) = delete;
+    BoundedThreadSafeQueue& operator=(const BoundedThreadSafeQueue&) = delete;
+
+    ~BoundedThreadSafeQueue()
+    {
+        for (size_t i = 0; i < size_; ++i)
+            slot((head_ + i) % capacity_)->~T();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return size_ == 0;
+    }
+
+    bool full()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return is_full();
+    }
+
+    // wakes all blocked producers and consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            is_closed_ = true;
+        }
+        cv_q_not_empty_.notify_all();
+        cv_q_not_full_.notify_all();
+    }
+
+    bool is_closed()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return is_closed_;
+    }
+
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    void push(std::initializer_list<T> items)
+    {
+        for (const auto& item : items)
+            push_item(item);
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_item(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_item(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        {
+            std::unique_lock<std::mutex> lk{mtx_q_, std::try_to_lock};
+
+            if (!lk.owns_lock() || size_ == 0)
+                return false;
+
+            dequeue(item);
+        }
+        cv_q_not_full_.notify_one();
+
+        return true;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+        cv_q_not_empty_.wait(lk, [this] { return is_ready_to_pop(); });
+
+        return pop_front(lk, item);
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+        if (!cv_q_not_empty_.wait_until(lk, timeout_time, [this] { return is_ready_to_pop(); }))
+            return QueueStatus::timeout;
+
+        return pop_front(lk, item);
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // BOUNDED_THREAD_SAFE_QUEUE_HPP
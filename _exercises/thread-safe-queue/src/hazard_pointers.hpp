@@ -0,0 +1,256 @@
+#ifndef HAZARD_POINTERS_HPP
+#define HAZARD_POINTERS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Safe memory reclamation for lock-free containers.
+// A thread publishes a pointer it is about to dereference in a hazard pointer (HazardPointer::protect);
+// a removed node is passed to retire_node() and deleted only when no hazard pointer points to it.
+// Every thread owns up to HazardPointerDomain::slots_per_thread hazard pointers at a time.
+// Hazard slots of a thread live in a record taken from a lock-free list - the list grows when all records
+// are in use and a record is reused by another thread after its owner has exited.
+class HazardPointerDomain
+{
+public:
+    static constexpr size_t slots_per_thread = 2;
+
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Record
+    {
+        std::atomic<bool> is_owned{true};
+        std::array<std::atomic<const void*>, slots_per_thread> slots{};
+        Record* next{nullptr}; // records are only prepended - next does not change once a record is in the list
+    };
+
+    struct RetiredNode
+    {
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    // hazard slots and retired nodes of the calling thread - returned to the domain at thread exit
+    class ThreadState
+    {
+        HazardPointerDomain& domain_;
+        Record* record_;
+        unsigned int used_slots_{0};
+        std::vector<RetiredNode> retired_;
+
+    public:
+        explicit ThreadState(HazardPointerDomain& domain) : domain_{domain}, record_{domain.acquire_record()}
+        {
+        }
+
+        ThreadState(const ThreadState&) = delete;
+        ThreadState& operator=(const ThreadState&) = delete;
+
+        ~ThreadState()
+        {
+            domain_.reclaim(retired_);
+            domain_.adopt_orphans(retired_);
+            record_->is_owned.store(false, std::memory_order_release);
+        }
+
+        std::atomic<const void*>& acquire_slot()
+        {
+            for (size_t i = 0; i < slots_per_thread; ++i)
+            {
+                if ((used_slots_ & (1u << i)) == 0)
+                {
+                    used_slots_ |= 1u << i;
+                    return record_->slots[i];
+                }
+            }
+
+            throw std::logic_error("too many hazard pointers in one thread");
+        }
+
+        void release_slot(std::atomic<const void*>& slot)
+        {
+            slot.store(nullptr, std::memory_order_release);
+            used_slots_ &= ~(1u << (&slot - record_->slots.data()));
+        }
+
+        void retire(RetiredNode node)
+        {
+            retired_.push_back(node);
+
+            if (retired_.size() >= domain_.scan_threshold())
+                domain_.reclaim(retired_);
+        }
+    };
+
+    static constexpr size_t min_scan_threshold = 64;
+
+    std::atomic<Record*> records_{nullptr};
+    std::atomic<size_t> no_of_records_{0};
+    std::mutex mtx_orphans_;
+    std::vector<RetiredNode> orphans_; // retired nodes left by threads that have exited
+
+    HazardPointerDomain() = default;
+
+    // a free record of the list or a new one
+    Record* acquire_record()
+    {
+        for (Record* record = records_.load(std::memory_order_acquire); record; record = record->next)
+        {
+            bool is_owned = false;
+            if (!record->is_owned.load(std::memory_order_relaxed)
+                && record->is_owned.compare_exchange_strong(is_owned, true, std::memory_order_acquire))
+                return record;
+        }
+
+        auto record = std::make_unique<Record>();
+        Record* head = records_.load(std::memory_order_relaxed);
+        do
+        {
+            record->next = head;
+        } while (!records_.compare_exchange_weak(head, record.get(), std::memory_order_release, std::memory_order_relaxed));
+
+        no_of_records_.fetch_add(1, std::memory_order_relaxed);
+
+        return record.release();
+    }
+
+    // deletes retired nodes that are not protected - the rest stays in retired
+    void reclaim(std::vector<RetiredNode>& retired)
+    {
+        {
+            std::unique_lock<std::mutex> lk{mtx_orphans_, std::try_to_lock};
+            if (lk.owns_lock() && !orphans_.empty())
+            {
+                retired.insert(retired.end(), orphans_.begin(), orphans_.end());
+                orphans_.clear();
+            }
+        }
+
+        std::vector<const void*> hazards;
+        hazards.reserve(record_count() * slots_per_thread);
+        for (const Record* record = records_.load(std::memory_order_acquire); record; record = record->next)
+            for (const auto& slot : record->slots)
+                if (const void* ptr = slot.load(std::memory_order_seq_cst))
+                    hazards.push_back(ptr);
+
+        std::sort(hazards.begin(), hazards.end());
+
+        auto still_protected = std::partition(retired.begin(), retired.end(), [&hazards](const RetiredNode& node) {
+            return std::binary_search(hazards.begin(), hazards.end(), node.ptr);
+        });
+
+        for (auto it = still_protected; it != retired.end(); ++it)
+            it->deleter(it->ptr);
+
+        retired.erase(still_protected, retired.end());
+    }
+
+    void adopt_orphans(std::vector<RetiredNode>& retired)
+    {
+        std::lock_guard<std::mutex> lk{mtx_orphans_};
+        orphans_.insert(orphans_.end(), retired.begin(), retired.end());
+        retired.clear();
+    }
+
+public:
+    HazardPointerDomain(const HazardPointerDomain&) = delete;
+    HazardPointerDomain& operator=(const HazardPointerDomain&) = delete;
+
+    // all other threads have exited - nothing can be protected any more
+    ~HazardPointerDomain()
+    {
+        for (const auto& node : orphans_)
+            node.deleter(node.ptr);
+
+        for (Record* record = records_.load(); record;)
+            delete std::exchange(record, record->next);
+    }
+
+    // number of records ever created - the highest number of threads that held hazard pointers at the same time
+    size_t record_count() const
+    {
+        return no_of_records_.load(std::memory_order_relaxed);
+    }
+
+    // amortizes the cost of a scan - at most record_count() * slots_per_thread nodes stay unreclaimed after it,
+    // so a scan deletes at least half of the retired nodes
+    size_t scan_threshold() const
+    {
+        return std::max(min_scan_threshold, 2 * record_count() * slots_per_thread);
+    }
+
+    static HazardPointerDomain& instance()
+    {
+        static HazardPointerDomain domain;
+        return domain;
+    }
+
+    static ThreadState& this_thread_state()
+    {
+        thread_local ThreadState state{instance()};
+        return state;
+    }
+
+    template <typename T>
+    static void retire(T* ptr)
+    {
+        this_thread_state().retire(RetiredNode{ptr, [](void* p) { delete static_cast<T*>(p); }});
+    }
+};
+
+// RAII owner of one hazard slot of the calling thread
+class HazardPointer
+{
+    std::atomic<const void*>& slot_;
+
+public:
+    HazardPointer() : slot_{HazardPointerDomain::this_thread_state().acquire_slot()}
+    {
+    }
+
+    HazardPointer(const HazardPointer&) = delete;
+    HazardPointer& operator=(const HazardPointer&) = delete;
+
+    ~HazardPointer()
+    {
+        HazardPointerDomain::this_thread_state().release_slot(slot_);
+    }
+
+    // loads src and publishes it as hazardous - the returned node is not deleted until reset
+    // (it can still be removed from a container, so the caller has to validate it)
+    template <typename T>
+    T* protect(const std::atomic<T*>& src)
+    {
+        T* ptr = src.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot_.store(ptr, std::memory_order_seq_cst);
+            T* current = src.load(std::memory_order_seq_cst);
+            if (current == ptr)
+                return ptr;
+            ptr = current;
+        }
+    }
+
+    void reset()
+    {
+        slot_.store(nullptr, std::memory_order_release);
+    }
+};
+
+// deletes ptr once no hazard pointer protects it - ptr must be already unreachable for other threads
+template <typename T>
+void retire_node(T* ptr)
+{
+    HazardPointerDomain::retire(ptr);
+}
+
+#endif // HAZARD_POINTERS_HPP
@@ -0,0 +1,149 @@
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "hazard_pointers.hpp"
+
+// Unbounded Michael-Scott queue - push and try_pop never take a lock, so a preempted thread does not stop others.
+// Removed nodes are reclaimed with hazard pointers (see hazard_pointers.hpp), which also rules out ABA.
+template <typename T>
+class LockFreeQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage; // constructed in all nodes except the dummy head
+
+        T& value()
+        {
+            return *reinterpret_cast<T*>(&storage);
+        }
+    };
+
+    alignas(cache_line_size) std::atomic<Node*> head_;
+    alignas(cache_line_size) std::atomic<Node*> tail_;
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        Node* node = new Node;
+        new (&node->storage) T(std::forward<U>(item));
+
+        HazardPointer hp_tail;
+        while (true)
+        {
+            Node* tail = hp_tail.protect(tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+
+            if (tail != tail_.load(std::memory_order_acquire))
+                continue;
+
+            if (next != nullptr)
+            {
+                // tail is lagging behind - help the other producer to swing it
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (tail->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+            {
+                tail_.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+public:
+    LockFreeQueue()
+    {
+        Node* dummy = new Node;
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    ~LockFreeQueue()
+    {
+        Node* head = head_.load(std::memory_order_relaxed);
+        Node* node = head->next.load(std::memory_order_relaxed);
+        delete head;
+
+        while (node != nullptr)
+        {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            node->value().~T();
+            delete node;
+            node = next;
+        }
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        HazardPointer hp_head;
+        HazardPointer hp_next;
+
+        while (true)
+        {
+            Node* head = hp_head.protect(head_);
+            Node* tail = tail_.load(std::memory_order_acquire);
+            Node* next = hp_next.protect(head->next);
+
+            if (head != head_.load(std::memory_order_acquire))
+                continue;
+
+            if (next == nullptr)
+                return false;
+
+            if (head == tail)
+            {
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                // next is the new dummy head - only the winner of the CAS touches its value
+                item = std::move(next->value());
+                next->value().~T();
+
+                hp_head.reset();
+                retire_node(head);
+
+                return true;
+            }
+        }
+    }
+
+    void pop(T& item)
+    {
+        while (!try_pop(item))
+            std::this_thread::yield();
+    }
+};
+
+#endif // LOCK_FREE_QUEUE_HPP
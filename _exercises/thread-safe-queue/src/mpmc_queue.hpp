@@ -0,0 +1,350 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "queue_status.hpp"
+
+// Bounded lock-free multi-producer/multi-consumer queue (D. Vyukov's algorithm).
+// Every cell carries a sequence number telling whether it is ready for a producer or a consumer
+// for a given lap of the ring. Locks are taken only by threads that have to block in push/pop.
+// The closed flag is the top bit of the enqueue position - a producer claims a cell with a CAS of the whole word,
+// so no cell is claimed after close() and consumers report closed only when every claimed cell has been popped.
+template <typename T>
+class MpmcQueue
+{
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t closed_bit = size_t{1} << (sizeof(size_t) * 8 - 1);
+
+    enum class PushResult
+    {
+        pushed,
+        full,
+        closed
+    };
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* item()
+        {
+            return reinterpret_cast<T*>(&storage);
+        }
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> buffer_;
+
+    alignas(cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+
+    alignas(cache_line_size) std::atomic<int> waiting_consumers_{0};
+    std::atomic<int> waiting_producers_{0};
+    std::mutex mtx_park_;
+    std::condition_variable cv_not_empty_;
+    std::condition_variable cv_not_full_;
+
+    static size_t round_up_to_power_of_2(size_t n)
+    {
+        size_t result = 2;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    static std::intptr_t distance(size_t sequence, size_t pos)
+    {
+        return static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+    }
+
+    void wake_one(const std::atomic<int>& waiting, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiting.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_park_};
+            }
+            cv.notify_one();
+        }
+    }
+
+    template <typename Predicate>
+    void park(std::atomic<int>& waiting, std::condition_variable& cv, Predicate try_operation)
+    {
+        std::unique_lock<std::mutex> lk{mtx_park_};
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv.wait(lk, try_operation);
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    template <typename Clock, typename Duration, typename Predicate>
+    bool park_until(std::atomic<int>& waiting, std::condition_variable& cv,
+        const std::chrono::time_point<Clock, Duration>& timeout_time, Predicate try_operation)
+    {
+        std::unique_lock<std::mutex> lk{mtx_park_};
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool result = cv.wait_until(lk, timeout_time, try_operation);
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+
+        return result;
+    }
+
+    // the item is left in place unless it is pushed
+    template <typename U>
+    PushResult enqueue(U&& item)
+    {
+        Cell* cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            if (pos & closed_bit)
+                return PushResult::closed;
+
+            cell = &buffer_[pos & mask_];
+            auto diff = distance(cell->sequence.load(std::memory_order_acquire), pos);
+
+            if (diff == 0)
+            {
+                // fails when close() has set the closed bit in the meantime
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return PushResult::full;
+            else
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+
+        new (cell->item()) T(std::forward<U>(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return PushResult::pushed;
+    }
+
+    // an item claimed before close() may be published after the consumers were woken by close() -
+    // then all of them are woken again, so they either pop it or see the drained queue
+    void notify_pushed()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (enqueue_pos_.load(std::memory_order_relaxed) & closed_bit)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_park_};
+            }
+            cv_not_empty_.notify_all();
+        }
+        else
+            wake_one(waiting_consumers_, cv_not_empty_);
+    }
+
+    // closed and every claimed cell has been popped
+    bool is_drained() const
+    {
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        return (tail & closed_bit) && dequeue_pos_.load(std::memory_order_acquire) == (tail & ~closed_bit);
+    }
+
+    bool dequeue(T& item)
+    {
+        Cell* cell;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &buffer_[pos & mask_];
+            auto diff = distance(cell->sequence.load(std::memory_order_acquire), pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+
+        item = std::move(*cell->item());
+        cell->item()->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    template <typename U>
+    bool try_push_item(U&& item)
+    {
+        const PushResult result = enqueue(std::forward<U>(item));
+
+        if (result == PushResult::closed)
+            throw QueueClosed{};
+        if (result == PushResult::full)
+            return false;
+
+        notify_pushed();
+
+        return true;
+    }
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        PushResult result = enqueue(std::forward<U>(item));
+        if (result == PushResult::full)
+        {
+            park(waiting_producers_, cv_not_full_, [&] {
+                result = enqueue(std::forward<U>(item));
+                return result != PushResult::full;
+            });
+        }
+
+        if (result == PushResult::closed)
+            throw QueueClosed{};
+
+        notify_pushed();
+    }
+
+    QueueStatus popped_status(bool popped)
+    {
+        if (!popped)
+            return QueueStatus::closed;
+
+        wake_one(waiting_producers_, cv_not_full_);
+
+        return QueueStatus::success;
+    }
+
+public:
+    // capacity is rounded up to a power of 2
+    explicit MpmcQueue(size_t capacity = 1024)
+        : mask_{round_up_to_power_of_2(capacity) - 1}, buffer_{new Cell[mask_ + 1]}
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue()
+    {
+        const size_t tail = enqueue_pos_.load(std::memory_order_relaxed) & ~closed_bit;
+        for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != tail; ++pos)
+            buffer_[pos & mask_].item()->~T();
+    }
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    bool empty() const
+    {
+        return dequeue_pos_.load(std::memory_order_acquire) >= (enqueue_pos_.load(std::memory_order_acquire) & ~closed_bit);
+    }
+
+    // wakes all blocked producers and consumers - items already in the queue (including items of pushes
+    // that claimed a cell before close) can still be popped, pushing new items throws QueueClosed
+    void close()
+    {
+        enqueue_pos_.fetch_or(closed_bit);
+        {
+            std::lock_guard<std::mutex> lk{mtx_park_};
+        }
+        cv_not_empty_.notify_all();
+        cv_not_full_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        return enqueue_pos_.load() & closed_bit;
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_item(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_item(std::move(item));
+    }
+
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        if (!dequeue(item))
+            return false;
+
+        wake_one(waiting_producers_, cv_not_full_);
+
+        return true;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        bool popped = dequeue(item);
+        if (!popped)
+        {
+            park(waiting_consumers_, cv_not_empty_, [&] {
+                popped = dequeue(item);
+                return popped || is_drained();
+            });
+        }
+
+        return popped_status(popped);
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        bool popped = dequeue(item);
+        if (!popped)
+        {
+            bool is_ready = park_until(waiting_consumers_, cv_not_empty_, timeout_time, [&] {
+                popped = dequeue(item);
+                return popped || is_drained();
+            });
+
+            if (!is_ready)
+                return QueueStatus::timeout;
+        }
+
+        return popped_status(popped);
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // MPMC_QUEUE_HPP
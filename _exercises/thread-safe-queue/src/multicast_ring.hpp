@@ -0,0 +1,265 @@
+#ifndef MULTICAST_RING_HPP
+#define MULTICAST_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "queue_status.hpp"
+#include "wait_policies.hpp"
+
+// Disruptor-style ring for one producer and many consumers - every consumer sees every item.
+// Items live in a preallocated ring and are written and read in place. Each consumer tracks its own cursor
+// (last processed sequence); the producer gates on the slowest consumer, so a slot is reused only after
+// all consumers are done with it. A consumer can depend on other consumers - it sees an item only after
+// all of its dependencies have processed it (e.g. replicate after persist).
+// WaitPolicy (see wait_policies.hpp) decides whether waiting threads spin before they park.
+template <typename T, typename WaitPolicy = BlockingWait>
+class MulticastRing
+{
+    static constexpr size_t cache_line_size = 64;
+
+public:
+    class alignas(cache_line_size) Consumer
+    {
+        friend class MulticastRing;
+
+        MulticastRing& ring_;
+        std::vector<const Consumer*> dependencies_;
+        std::atomic<int64_t> cursor_{-1};
+
+        Consumer(MulticastRing& ring, std::initializer_list<const Consumer*> dependencies)
+            : ring_{ring}, dependencies_{dependencies}
+        {
+        }
+
+        // the highest sequence this consumer is allowed to read
+        int64_t barrier() const
+        {
+            int64_t available = ring_.published_.load(std::memory_order_acquire);
+            for (const Consumer* dependency : dependencies_)
+                available = std::min(available, dependency->cursor_.load(std::memory_order_acquire));
+            return available;
+        }
+
+        template <typename Handler>
+        size_t process(int64_t available, Handler& handler, size_t max_batch)
+        {
+            const int64_t first = cursor_.load(std::memory_order_relaxed) + 1;
+            const size_t count = std::min(static_cast<size_t>(available - first + 1), max_batch);
+
+            for (size_t i = 0; i < count; ++i)
+                handler(static_cast<const T&>(ring_.slot(first + static_cast<int64_t>(i))));
+
+            cursor_.store(first + static_cast<int64_t>(count) - 1, std::memory_order_release);
+            ring_.wake_all();
+
+            return count;
+        }
+
+    public:
+        Consumer(const Consumer&) = delete;
+        Consumer& operator=(const Consumer&) = delete;
+
+        // passes available items (up to max_batch) to handler(const T&) in place without waiting -
+        // returns number of processed items
+        template <typename Handler>
+        size_t try_consume(Handler&& handler, size_t max_batch = std::numeric_limits<size_t>::max())
+        {
+            const int64_t available = barrier();
+            if (available <= cursor_.load(std::memory_order_relaxed))
+                return 0;
+
+            return process(available, handler, max_batch);
+        }
+
+        // waits for at least one item and passes available items (up to max_batch) to handler(const T&) in place -
+        // returns number of processed items (0 only when the ring is closed and this consumer has seen all items)
+        template <typename Handler>
+        size_t consume(Handler&& handler, size_t max_batch = std::numeric_limits<size_t>::max())
+        {
+            const int64_t next = cursor_.load(std::memory_order_relaxed) + 1;
+            int64_t available = barrier();
+
+            if (available < next)
+            {
+                bool is_done = false;
+                ring_.wait_until_ready([&] {
+                    // is_closed_ is read first - after close() the published sequence does not change any more
+                    const bool is_closed = ring_.is_closed_.load(std::memory_order_acquire);
+                    available = barrier();
+                    is_done = available < next && is_closed && available == ring_.published_.load(std::memory_order_acquire);
+                    return available >= next || is_done;
+                });
+
+                if (is_done)
+                    return 0;
+            }
+
+            return process(available, handler, max_batch);
+        }
+    };
+
+private:
+    const size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+
+    // producer side
+    alignas(cache_line_size) std::atomic<int64_t> published_{-1};
+    int64_t cached_gating_sequence_{-1};
+    std::atomic<bool> is_closed_{false};
+
+    alignas(cache_line_size) std::atomic<int> waiting_{0};
+    std::mutex mtx_park_;
+    std::condition_variable cv_progress_;
+    WaitPolicy wait_policy_;
+
+    static size_t round_up_to_power_of_2(size_t n)
+    {
+        size_t result = 1;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    T& slot(int64_t sequence)
+    {
+        return buffer_[static_cast<size_t>(sequence) & mask_];
+    }
+
+    int64_t gating_sequence() const
+    {
+        int64_t slowest = published_.load(std::memory_order_relaxed);
+        for (const auto& consumer : consumers_)
+            slowest = std::min(slowest, consumer->cursor_.load(std::memory_order_acquire));
+        return slowest;
+    }
+
+    bool has_free_slot(int64_t sequence)
+    {
+        const int64_t wrap_point = sequence - static_cast<int64_t>(mask_ + 1);
+
+        if (wrap_point > cached_gating_sequence_)
+            cached_gating_sequence_ = gating_sequence();
+
+        return wrap_point <= cached_gating_sequence_;
+    }
+
+    template <typename Predicate>
+    void wait_until_ready(Predicate is_ready)
+    {
+        wait_policy_.spin(is_ready);
+
+        if (is_ready())
+            return;
+
+        wait_policy_.park([&] {
+            std::unique_lock<std::mutex> lk{mtx_park_};
+            waiting_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv_progress_.wait(lk, is_ready);
+            waiting_.fetch_sub(1, std::memory_order_relaxed);
+        });
+    }
+
+    // the producer and consumers wait for different cursors, so every waiter is woken up
+    void wake_all()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiting_.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_park_};
+            }
+            cv_progress_.notify_all();
+        }
+    }
+
+    template <typename Writer>
+    void publish_to(int64_t sequence, Writer& write)
+    {
+        write(slot(sequence));
+        published_.store(sequence, std::memory_order_release);
+        wake_all();
+    }
+
+public:
+    // capacity is rounded up to a power of 2
+    explicit MulticastRing(size_t capacity = 1024, const WaitPolicy& wait_policy = WaitPolicy{})
+        : mask_{round_up_to_power_of_2(capacity) - 1}, buffer_{new T[mask_ + 1]}, wait_policy_{wait_policy}
+    {
+    }
+
+    MulticastRing(const MulticastRing&) = delete;
+    MulticastRing& operator=(const MulticastRing&) = delete;
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    // must be called before the first item is published
+    Consumer& add_consumer(std::initializer_list<const Consumer*> dependencies = {})
+    {
+        consumers_.emplace_back(new Consumer{*this, dependencies});
+        return *consumers_.back();
+    }
+
+    // producer only - write(T&) fills the next slot in place, blocks while the slowest consumer is a full ring behind
+    template <typename Writer>
+    void publish(Writer&& write)
+    {
+        if (is_closed_.load(std::memory_order_relaxed))
+            throw QueueClosed{};
+
+        const int64_t sequence = published_.load(std::memory_order_relaxed) + 1;
+
+        if (!has_free_slot(sequence))
+            wait_until_ready([&] { return has_free_slot(sequence); });
+
+        publish_to(sequence, write);
+    }
+
+    template <typename Writer>
+    bool try_publish(Writer&& write)
+    {
+        if (is_closed_.load(std::memory_order_relaxed))
+            throw QueueClosed{};
+
+        const int64_t sequence = published_.load(std::memory_order_relaxed) + 1;
+
+        if (!has_free_slot(sequence))
+            return false;
+
+        publish_to(sequence, write);
+        return true;
+    }
+
+    void push(const T& item)
+    {
+        publish([&item](T& slot) { slot = item; });
+    }
+
+    void push(T&& item)
+    {
+        publish([&item](T& slot) { slot = std::move(item); });
+    }
+
+    // producer only - consumers process all published items and then their consume returns 0
+    void close()
+    {
+        is_closed_.store(true, std::memory_order_release);
+        wake_all();
+    }
+};
+
+#endif // MULTICAST_RING_HPP
@@ -0,0 +1,189 @@
+#ifndef PRIORITY_THREAD_SAFE_QUEUE_HPP
+#define PRIORITY_THREAD_SAFE_QUEUE_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+
+#include "bit_utils.hpp"
+#include "queue_status.hpp"
+
+// Concurrent queue with a fixed number of priority levels (0 is the most urgent), FIFO within a level.
+// A bitmap of non-empty levels finds the most urgent item in O(1). To prevent starvation a non-empty level
+// that has been passed over aging_threshold times is served before more urgent levels.
+template <typename T, size_t Levels = 3>
+class PriorityThreadSafeQueue
+{
+    static_assert(Levels >= 1 && Levels <= 64, "number of priority levels must be in range [1, 64]");
+
+    std::array<std::deque<T>, Levels> lanes_;
+    std::array<unsigned int, Levels> skipped_{};
+    uint64_t non_empty_levels_{0};
+    const unsigned int aging_threshold_;
+
+    std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+    size_t waiting_consumers_{0};
+    bool is_closed_{false};
+
+    static uint64_t level_bit(size_t level)
+    {
+        return uint64_t{1} << level;
+    }
+
+    bool is_ready_to_pop() const
+    {
+        return non_empty_levels_ != 0 || is_closed_;
+    }
+
+    size_t select_level()
+    {
+        const size_t most_urgent = lowest_set_bit(non_empty_levels_);
+
+        size_t selected = most_urgent;
+        uint64_t passed_over = non_empty_levels_ & ~level_bit(most_urgent);
+        while (passed_over != 0)
+        {
+            const size_t level = lowest_set_bit(passed_over);
+            passed_over &= passed_over - 1;
+
+            if (skipped_[level] >= aging_threshold_ && selected == most_urgent)
+                selected = level;
+            else
+                ++skipped_[level];
+        }
+
+        skipped_[selected] = 0;
+
+        return selected;
+    }
+
+    // must be called with mtx_q_ locked
+    QueueStatus pop_front(T& item)
+    {
+        if (non_empty_levels_ == 0)
+            return QueueStatus::closed;
+
+        const size_t level = select_level();
+        auto& lane = lanes_[level];
+
+        item = std::move(lane.front());
+        lane.pop_front();
+
+        if (lane.empty())
+            non_empty_levels_ &= ~level_bit(level);
+
+        return QueueStatus::success;
+    }
+
+    template <typename U>
+    void push_item(U&& item, size_t priority)
+    {
+        if (priority >= Levels)
+            throw std::out_of_range("priority level out of range");
+
+        bool has_waiting_consumers;
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+
+            if (is_closed_)
+                throw QueueClosed{};
+
+            lanes_[priority].push_back(std::forward<U>(item));
+            non_empty_levels_ |= level_bit(priority);
+            has_waiting_consumers = waiting_consumers_ > 0;
+        }
+
+        if (has_waiting_consumers)
+            cv_q_not_empty_.notify_one();
+    }
+
+public:
+    static constexpr size_t no_of_levels = Levels;
+    static constexpr size_t default_priority = Levels / 2;
+
+    explicit PriorityThreadSafeQueue(unsigned int aging_threshold = 64) : aging_threshold_{aging_threshold}
+    {
+    }
+
+    PriorityThreadSafeQueue(const PriorityThreadSafeQueue&) = delete;
+    PriorityThreadSafeQueue& operator=(const PriorityThreadSafeQueue&) = delete;
+
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return non_empty_levels_ == 0;
+    }
+
+    // wakes all blocked consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            is_closed_ = true;
+        }
+        cv_q_not_empty_.notify_all();
+    }
+
+    bool is_closed()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return is_closed_;
+    }
+
+    void push(const T& item, size_t priority = default_priority)
+    {
+        push_item(item, priority);
+    }
+
+    void push(T&& item, size_t priority = default_priority)
+    {
+        push_item(std::move(item), priority);
+    }
+
+    bool try_pop(T& item)
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return non_empty_levels_ != 0 && pop_front(item) == QueueStatus::success;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+
+        ++waiting_consumers_;
+        cv_q_not_empty_.wait(lk, [this] { return is_ready_to_pop(); });
+        --waiting_consumers_;
+
+        return pop_front(item);
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+
+        ++waiting_consumers_;
+        const bool is_ready = cv_q_not_empty_.wait_until(lk, timeout_time, [this] { return is_ready_to_pop(); });
+        --waiting_consumers_;
+
+        if (!is_ready)
+            return QueueStatus::timeout;
+
+        return pop_front(item);
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // PRIORITY_THREAD_SAFE_QUEUE_HPP
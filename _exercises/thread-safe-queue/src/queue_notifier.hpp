@@ -0,0 +1,78 @@
+#ifndef QUEUE_NOTIFIER_HPP
+#define QUEUE_NOTIFIER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Notification object shared by up to 64 queues - a queue calls notify(source) with its own source number
+// after every push and on close, a waiter takes the set of signalled sources. Signalling is skipped while nobody waits.
+class QueueNotifier
+{
+    std::atomic<uint64_t> pending_{0};
+    std::atomic<int> waiting_{0};
+    std::mutex mtx_;
+    std::condition_variable cv_signalled_;
+
+    bool is_pending() const
+    {
+        return pending_.load(std::memory_order_seq_cst) != 0;
+    }
+
+public:
+    static constexpr unsigned int max_sources = 64;
+
+    QueueNotifier() = default;
+    QueueNotifier(const QueueNotifier&) = delete;
+    QueueNotifier& operator=(const QueueNotifier&) = delete;
+
+    void notify(unsigned int source)
+    {
+        const uint64_t source_bit = uint64_t{1} << source;
+
+        if ((pending_.load(std::memory_order_relaxed) & source_bit) == 0)
+            pending_.fetch_or(source_bit, std::memory_order_seq_cst);
+        else
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiting_.load(std::memory_order_seq_cst) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_};
+            }
+            cv_signalled_.notify_all();
+        }
+    }
+
+    // bitmask of sources signalled since the previous call
+    uint64_t take_pending()
+    {
+        return pending_.exchange(0, std::memory_order_acq_rel);
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lk{mtx_};
+
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        cv_signalled_.wait(lk, [this] { return is_pending(); });
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // returns false on timeout
+    template <typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        std::unique_lock<std::mutex> lk{mtx_};
+
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        const bool is_signalled = cv_signalled_.wait_until(lk, timeout_time, [this] { return is_pending(); });
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+
+        return is_signalled;
+    }
+};
+
+#endif // QUEUE_NOTIFIER_HPP
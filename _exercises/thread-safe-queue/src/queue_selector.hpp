@@ -0,0 +1,128 @@
+#ifndef QUEUE_SELECTOR_HPP
+#define QUEUE_SELECTOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "bit_utils.hpp"
+#include "queue_notifier.hpp"
+
+// Blocks until any of the registered queues (up to 64) has an item or is closed and reports which one.
+// All queues signal one shared QueueNotifier with their own bit, so a single thread can serve many queues
+// without polling - only queues that were signalled are checked.
+// Queue has to provide set_notifier, empty and is_closed (e.g. ThreadSafeQueue). A queue can be registered
+// in one selector at a time; the selector detaches itself from its queues in the destructor.
+class QueueSelector
+{
+    struct Source
+    {
+        std::function<bool()> is_ready;
+        std::function<void()> detach;
+    };
+
+    QueueNotifier notifier_;
+    std::vector<Source> sources_;
+    uint64_t candidates_{0}; // queues that may be ready
+    size_t next_{0};
+
+    static uint64_t rotate_right(uint64_t bits, unsigned int shift)
+    {
+        return shift == 0 ? bits : (bits >> shift) | (bits << (64 - shift));
+    }
+
+    // candidates are checked round-robin, so a busy queue does not starve the others
+    size_t find_ready()
+    {
+        candidates_ |= notifier_.take_pending();
+
+        while (candidates_ != 0)
+        {
+            const size_t offset = lowest_set_bit(rotate_right(candidates_, next_ % 64));
+            const size_t index = (next_ + offset) % 64;
+
+            if (sources_[index].is_ready())
+            {
+                // stays a candidate - the queue can hold more items
+                next_ = index + 1;
+                return index;
+            }
+
+            candidates_ &= ~(uint64_t{1} << index);
+        }
+
+        return npos;
+    }
+
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    QueueSelector() = default;
+    QueueSelector(const QueueSelector&) = delete;
+    QueueSelector& operator=(const QueueSelector&) = delete;
+
+    ~QueueSelector()
+    {
+        for (auto& source : sources_)
+            source.detach();
+    }
+
+    // returns index of the queue reported by wait
+    template <typename Queue>
+    size_t add(Queue& q)
+    {
+        const size_t index = sources_.size();
+        if (index == QueueNotifier::max_sources)
+            throw std::length_error("too many queues in a selector");
+
+        sources_.push_back(Source{[&q] { return !q.empty() || q.is_closed(); }, [&q] { q.set_notifier(nullptr); }});
+        q.set_notifier(&notifier_, static_cast<unsigned int>(index));
+        candidates_ |= uint64_t{1} << index;
+
+        return index;
+    }
+
+    // stops watching the queue (e.g. after it was closed and drained) - indexes of other queues do not change
+    void remove(size_t index)
+    {
+        sources_[index].detach();
+        sources_[index] = Source{[] { return false; }, [] {}};
+    }
+
+    // returns index of a queue that has an item or is closed - the item can still be taken by another consumer,
+    // so pop it with try_pop
+    size_t wait()
+    {
+        size_t index;
+        while ((index = find_ready()) == npos)
+            notifier_.wait();
+
+        return index;
+    }
+
+    // returns npos on timeout
+    template <typename Clock, typename Duration>
+    size_t wait_until(const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        size_t index;
+        while ((index = find_ready()) == npos)
+        {
+            if (!notifier_.wait_until(timeout_time))
+                return npos;
+        }
+
+        return index;
+    }
+
+    template <typename Rep, typename Period>
+    size_t wait_for(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // QUEUE_SELECTOR_HPP
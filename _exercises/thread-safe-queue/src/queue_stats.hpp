@@ -0,0 +1,259 @@
+#ifndef QUEUE_STATS_HPP
+#define QUEUE_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <sstream>
+#include <string>
+
+// Stats policies for ThreadSafeQueue. NoQueueStats (default) compiles every hook to nothing;
+// QueueStats collects counters and latency histograms that can be read with snapshot().
+// All hooks except on_consumer_blocked are called with the queue lock held.
+
+struct NoQueueStats
+{
+    static constexpr bool is_enabled = false;
+
+    void on_lock_contended()
+    {
+    }
+
+    void on_push(size_t)
+    {
+    }
+
+    void on_pop(size_t)
+    {
+    }
+
+    void on_consumer_blocked(std::chrono::nanoseconds)
+    {
+    }
+};
+
+// HDR-style histogram of nanosecond latencies - every power of 2 is split into 4 linear sub-buckets,
+// so a recorded value is off by at most 25%
+class LatencyHistogram
+{
+public:
+    static constexpr int sub_bucket_bits = 2;
+    static constexpr int sub_buckets = 1 << sub_bucket_bits;
+    static constexpr int no_of_buckets = 64 * sub_buckets;
+
+    struct Snapshot
+    {
+        std::array<uint64_t, no_of_buckets> counts{};
+
+        uint64_t count() const
+        {
+            uint64_t total = 0;
+            for (auto c : counts)
+                total += c;
+            return total;
+        }
+
+        // upper bound of a bucket containing the given percentile (0 - 100)
+        uint64_t percentile(double p) const
+        {
+            const uint64_t total = count();
+            if (total == 0)
+                return 0;
+
+            const uint64_t rank = static_cast<uint64_t>(p / 100.0 * (total - 1)) + 1;
+            uint64_t seen = 0;
+            for (int i = 0; i < no_of_buckets; ++i)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                    return bucket_upper_bound(i);
+            }
+
+            return bucket_upper_bound(no_of_buckets - 1);
+        }
+
+        uint64_t max() const
+        {
+            for (int i = no_of_buckets - 1; i >= 0; --i)
+                if (counts[i] != 0)
+                    return bucket_upper_bound(i);
+            return 0;
+        }
+
+        Snapshot& operator+=(const Snapshot& other)
+        {
+            for (int i = 0; i < no_of_buckets; ++i)
+                counts[i] += other.counts[i];
+            return *this;
+        }
+
+        std::string to_json() const
+        {
+            std::ostringstream out;
+            out << "{\"count\":" << count() << ",\"p50\":" << percentile(50) << ",\"p90\":" << percentile(90)
+                << ",\"p99\":" << percentile(99) << ",\"max\":" << max() << "}";
+            return out.str();
+        }
+    };
+
+    static int bucket_index(uint64_t value)
+    {
+        if (value < sub_buckets)
+            return static_cast<int>(value);
+
+        int exponent = 63;
+        while ((value >> exponent) == 0)
+            --exponent;
+
+        const int sub_bucket = static_cast<int>((value >> (exponent - sub_bucket_bits)) & (sub_buckets - 1));
+
+        return (exponent - sub_bucket_bits + 1) * sub_buckets + sub_bucket;
+    }
+
+    static uint64_t bucket_upper_bound(int index)
+    {
+        if (index < sub_buckets)
+            return static_cast<uint64_t>(index);
+
+        const int exponent = index / sub_buckets + sub_bucket_bits - 1;
+        const uint64_t sub_bucket = static_cast<uint64_t>(index % sub_buckets);
+        const uint64_t lower = (uint64_t{1} << exponent) + (sub_bucket << (exponent - sub_bucket_bits));
+
+        return lower + (uint64_t{1} << (exponent - sub_bucket_bits)) - 1;
+    }
+
+    void record(std::chrono::nanoseconds value)
+    {
+        const auto ns = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+        counts_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void add_to(Snapshot& snapshot) const
+    {
+        for (int i = 0; i < no_of_buckets; ++i)
+            snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, no_of_buckets> counts_{};
+};
+
+struct QueueStatsSnapshot
+{
+    size_t depth{};
+    size_t high_water_mark{};
+    uint64_t pushes{};
+    uint64_t pops{};
+    uint64_t lock_contentions{};
+    LatencyHistogram::Snapshot queued_time;
+    LatencyHistogram::Snapshot blocked_time;
+
+    std::string to_json() const
+    {
+        std::ostringstream out;
+        out << "{\"depth\":" << depth << ",\"high_water_mark\":" << high_water_mark << ",\"pushes\":" << pushes
+            << ",\"pops\":" << pops << ",\"lock_contentions\":" << lock_contentions
+            << ",\"queued_time_ns\":" << queued_time.to_json() << ",\"blocked_time_ns\":" << blocked_time.to_json() << "}";
+        return out.str();
+    }
+};
+
+// Counters and histograms are sharded per thread (threads are spread over no_of_shards cache-aligned shards),
+// so the instrumentation does not add another contended cache line to the queue.
+class QueueStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t no_of_shards = 16;
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Shard
+    {
+        std::atomic<uint64_t> pushes{0};
+        std::atomic<uint64_t> pops{0};
+        std::atomic<uint64_t> lock_contentions{0};
+        LatencyHistogram queued_time;
+        LatencyHistogram blocked_time;
+    };
+
+    std::array<Shard, no_of_shards> shards_;
+    std::atomic<size_t> depth_{0};
+    std::atomic<size_t> high_water_mark_{0};
+    std::deque<Clock::time_point> enqueue_times_; // guarded by the queue lock - FIFO like the queue itself
+
+    static size_t shard_index()
+    {
+        static std::atomic<size_t> next_thread_index{0};
+        thread_local const size_t index = next_thread_index++ % no_of_shards;
+        return index;
+    }
+
+    Shard& local_shard()
+    {
+        return shards_[shard_index()];
+    }
+
+public:
+    static constexpr bool is_enabled = true;
+
+    QueueStats() = default;
+    QueueStats(const QueueStats&) = delete;
+    QueueStats& operator=(const QueueStats&) = delete;
+
+    void on_lock_contended()
+    {
+        local_shard().lock_contentions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void on_push(size_t depth)
+    {
+        local_shard().pushes.fetch_add(1, std::memory_order_relaxed);
+        enqueue_times_.push_back(Clock::now());
+
+        depth_.store(depth, std::memory_order_relaxed);
+        if (depth > high_water_mark_.load(std::memory_order_relaxed))
+            high_water_mark_.store(depth, std::memory_order_relaxed);
+    }
+
+    void on_pop(size_t depth)
+    {
+        Shard& shard = local_shard();
+        shard.pops.fetch_add(1, std::memory_order_relaxed);
+
+        if (!enqueue_times_.empty())
+        {
+            shard.queued_time.record(Clock::now() - enqueue_times_.front());
+            enqueue_times_.pop_front();
+        }
+
+        depth_.store(depth, std::memory_order_relaxed);
+    }
+
+    void on_consumer_blocked(std::chrono::nanoseconds blocked_time)
+    {
+        local_shard().blocked_time.record(blocked_time);
+    }
+
+    QueueStatsSnapshot snapshot() const
+    {
+        QueueStatsSnapshot result;
+        result.depth = depth_.load(std::memory_order_relaxed);
+        result.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+
+        for (const auto& shard : shards_)
+        {
+            result.pushes += shard.pushes.load(std::memory_order_relaxed);
+            result.pops += shard.pops.load(std::memory_order_relaxed);
+            result.lock_contentions += shard.lock_contentions.load(std::memory_order_relaxed);
+            shard.queued_time.add_to(result.queued_time);
+            shard.blocked_time.add_to(result.blocked_time);
+        }
+
+        return result;
+    }
+};
+
+#endif // QUEUE_STATS_HPP
@@ -0,0 +1,21 @@
+#ifndef QUEUE_STATUS_HPP
+#define QUEUE_STATUS_HPP
+
+#include <stdexcept>
+
+enum class QueueStatus
+{
+    success,
+    timeout,
+    closed // queue was closed and all items have been popped
+};
+
+class QueueClosed : public std::logic_error
+{
+public:
+    QueueClosed() : std::logic_error{"push to a closed queue"}
+    {
+    }
+};
+
+#endif // QUEUE_STATUS_HPP
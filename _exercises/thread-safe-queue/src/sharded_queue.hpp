@@ -0,0 +1,190 @@
+#ifndef SHARDED_QUEUE_HPP
+#define SHARDED_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "queue_status.hpp"
+
+// Queue built from independent lanes (each with its own lock) to spread producer contention.
+// Every producer thread is assigned a lane round-robin on its first push and always pushes there,
+// so items of one producer are popped in FIFO order. There is no global FIFO order between producers.
+// Consumers scan lanes from a random starting point and park on a shared notifier when all lanes are empty.
+template <typename T>
+class ShardedQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Lane
+    {
+        std::mutex mtx;
+        std::deque<T> items;
+    };
+
+    const size_t no_of_lanes_;
+    std::unique_ptr<Lane[]> lanes_;
+
+    alignas(cache_line_size) std::atomic<std::ptrdiff_t> size_{0};
+    std::atomic<int> waiting_consumers_{0};
+    std::atomic<bool> is_closed_{false};
+    std::mutex mtx_notifier_;
+    std::condition_variable cv_not_empty_;
+
+    static size_t producer_id()
+    {
+        static std::atomic<size_t> next_producer_id{0};
+        thread_local const size_t id = next_producer_id++;
+        return id;
+    }
+
+    static size_t random_lane_offset()
+    {
+        // xorshift - cheap per-thread pseudo random numbers
+        thread_local size_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    bool pop_from_lane(Lane& lane, std::unique_lock<std::mutex>& lk, T& item)
+    {
+        if (!lk.owns_lock() || lane.items.empty())
+            return false;
+
+        item = std::move(lane.items.front());
+        lane.items.pop_front();
+        lk.unlock();
+
+        size_.fetch_sub(1);
+
+        return true;
+    }
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        Lane& lane = lanes_[producer_id() % no_of_lanes_];
+        {
+            // close() sets the flag with all lane locks held - an item pushed before is already counted in size_
+            std::lock_guard<std::mutex> lk{lane.mtx};
+            if (is_closed_.load())
+                throw QueueClosed{};
+
+            lane.items.push_back(std::forward<U>(item));
+            size_.fetch_add(1);
+        }
+
+        if (waiting_consumers_.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_notifier_};
+            }
+            cv_not_empty_.notify_one();
+        }
+    }
+
+public:
+    explicit ShardedQueue(size_t no_of_lanes = std::max(std::thread::hardware_concurrency(), 1u))
+        : no_of_lanes_{std::max<size_t>(no_of_lanes, 1)}, lanes_{new Lane[no_of_lanes_]}
+    {
+    }
+
+    ShardedQueue(const ShardedQueue&) = delete;
+    ShardedQueue& operator=(const ShardedQueue&) = delete;
+
+    size_t no_of_lanes() const
+    {
+        return no_of_lanes_;
+    }
+
+    bool empty() const
+    {
+        return size_.load() <= 0;
+    }
+
+    // wakes all blocked consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
+    {
+        {
+            std::vector<std::unique_lock<std::mutex>> lane_locks;
+            lane_locks.reserve(no_of_lanes_);
+            for (size_t i = 0; i < no_of_lanes_; ++i)
+                lane_locks.emplace_back(lanes_[i].mtx);
+
+            is_closed_.store(true);
+        }
+        {
+            std::lock_guard<std::mutex> lk{mtx_notifier_};
+        }
+        cv_not_empty_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        return is_closed_.load();
+    }
+
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        const size_t start = random_lane_offset();
+
+        // first pass skips lanes locked by someone else, second pass waits for lane locks
+        for (size_t i = 0; i < no_of_lanes_; ++i)
+        {
+            Lane& lane = lanes_[(start + i) % no_of_lanes_];
+            std::unique_lock<std::mutex> lk{lane.mtx, std::try_to_lock};
+            if (pop_from_lane(lane, lk, item))
+                return true;
+        }
+
+        for (size_t i = 0; i < no_of_lanes_ && size_.load() > 0; ++i)
+        {
+            Lane& lane = lanes_[(start + i) % no_of_lanes_];
+            std::unique_lock<std::mutex> lk{lane.mtx};
+            if (pop_from_lane(lane, lk, item))
+                return true;
+        }
+
+        return false;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        while (!try_pop(item))
+        {
+            std::unique_lock<std::mutex> lk{mtx_notifier_};
+
+            waiting_consumers_.fetch_add(1);
+            cv_not_empty_.wait(lk, [this] { return size_.load() > 0 || is_closed_.load(); });
+            waiting_consumers_.fetch_sub(1);
+
+            // closed flag first - once it is set, size_ counts every item that was pushed
+            if (is_closed_.load() && size_.load() <= 0)
+                return QueueStatus::closed;
+        }
+
+        return QueueStatus::success;
+    }
+};
+
+#endif // SHARDED_QUEUE_HPP
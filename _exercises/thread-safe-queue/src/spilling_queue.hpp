@@ -0,0 +1,307 @@
+#ifndef SPILLING_QUEUE_HPP
+#define SPILLING_QUEUE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "queue_status.hpp"
+
+// Memory-mapped, append-only file holding a fixed number of items - the file is removed in the destructor (POSIX only)
+template <typename T>
+class SpillSegment
+{
+    static_assert(std::is_trivially_copyable<T>::value, "spilled items have to be trivially copyable");
+
+    std::string path_;
+    size_t capacity_;
+    int fd_{-1};
+    T* items_{nullptr};
+    size_t write_index_{0};
+    size_t read_index_{0};
+
+    [[noreturn]] void throw_system_error(const char* what)
+    {
+        const int error = errno;
+        release();
+        throw std::system_error(error, std::generic_category(), std::string{what} + " " + path_);
+    }
+
+    void release()
+    {
+        if (items_)
+            ::munmap(items_, capacity_ * sizeof(T));
+        if (fd_ != -1)
+        {
+            ::close(fd_);
+            ::unlink(path_.c_str());
+        }
+    }
+
+public:
+    SpillSegment(std::string path, size_t capacity) : path_{std::move(path)}, capacity_{capacity}
+    {
+        const size_t size_in_bytes = capacity_ * sizeof(T);
+
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd_ == -1)
+            throw_system_error("cannot create spill segment");
+
+        if (::ftruncate(fd_, static_cast<off_t>(size_in_bytes)) == -1)
+            throw_system_error("cannot resize spill segment");
+
+        void* mapping = ::mmap(nullptr, size_in_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED)
+            throw_system_error("cannot map spill segment");
+
+        items_ = static_cast<T*>(mapping);
+        ::madvise(mapping, size_in_bytes, MADV_SEQUENTIAL);
+    }
+
+    SpillSegment(const SpillSegment&) = delete;
+    SpillSegment& operator=(const SpillSegment&) = delete;
+
+    ~SpillSegment()
+    {
+        release();
+    }
+
+    bool is_full() const
+    {
+        return write_index_ == capacity_;
+    }
+
+    // all items were written and read
+    bool is_consumed() const
+    {
+        return read_index_ == capacity_;
+    }
+
+    size_t readable() const
+    {
+        return write_index_ - read_index_;
+    }
+
+    void append(const T& item)
+    {
+        std::memcpy(static_cast<void*>(items_ + write_index_++), &item, sizeof(T));
+    }
+
+    T read()
+    {
+        T item;
+        std::memcpy(static_cast<void*>(&item), items_ + read_index_++, sizeof(T));
+        return item;
+    }
+};
+
+// Queue that keeps up to memory_capacity items in memory and spills the overflow to memory-mapped segment files
+// in a given directory, so a stalled consumer does not exhaust RAM and nothing is dropped.
+// As long as nothing is spilled push and pop work in memory only. Once items are spilled, new items are appended
+// to the segments as well (to keep FIFO order) and consumers move them back to memory in order as they catch up.
+// Segment files are deleted as soon as they are consumed. Spilled items do not survive a restart.
+template <typename T>
+class SpillingQueue
+{
+    static_assert(std::is_trivially_copyable<T>::value, "spilled items have to be trivially copyable");
+
+    using Segment = SpillSegment<T>;
+
+    const std::string directory_;
+    const std::string file_prefix_;
+    const size_t memory_capacity_;
+    const size_t items_per_segment_;
+
+    std::deque<T> memory_;
+    std::deque<std::unique_ptr<Segment>> segments_;
+    size_t spilled_{0};
+    size_t next_segment_id_{0};
+
+    std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+    size_t waiting_consumers_{0};
+    bool is_closed_{false};
+
+    static std::string unique_file_prefix()
+    {
+        static std::atomic<unsigned int> next_queue_id{0};
+        return "spill-" + std::to_string(::getpid()) + "-" + std::to_string(next_queue_id++) + "-";
+    }
+
+    void spill(const T& item)
+    {
+        if (segments_.empty() || segments_.back()->is_full())
+        {
+            const auto path = directory_ + "/" + file_prefix_ + std::to_string(next_segment_id_++) + ".seg";
+            segments_.emplace_back(new Segment{path, items_per_segment_});
+        }
+
+        segments_.back()->append(item);
+        ++spilled_;
+    }
+
+    // moves spilled items back to memory when the in-memory window is half empty
+    void refill()
+    {
+        if (spilled_ == 0 || memory_.size() > memory_capacity_ / 2)
+            return;
+
+        while (spilled_ > 0 && memory_.size() < memory_capacity_)
+        {
+            Segment& segment = *segments_.front();
+
+            for (size_t n = segment.readable(); n > 0 && memory_.size() < memory_capacity_; --n)
+            {
+                memory_.push_back(segment.read());
+                --spilled_;
+            }
+
+            if (segment.is_consumed())
+                segments_.pop_front();
+        }
+    }
+
+    bool is_ready_to_pop() const
+    {
+        return !memory_.empty() || spilled_ > 0 || is_closed_;
+    }
+
+    // must be called with mtx_q_ locked
+    QueueStatus pop_front(T& item)
+    {
+        refill();
+
+        if (memory_.empty())
+            return QueueStatus::closed;
+
+        item = memory_.front();
+        memory_.pop_front();
+
+        return QueueStatus::success;
+    }
+
+public:
+    // items_per_segment sets the size of a segment file (items_per_segment * sizeof(T) bytes)
+    explicit SpillingQueue(std::string directory, size_t memory_capacity = 1024, size_t items_per_segment = 64 * 1024)
+        : directory_{std::move(directory)}, file_prefix_{unique_file_prefix()}, memory_capacity_{memory_capacity},
+          items_per_segment_{items_per_segment}
+    {
+        if (memory_capacity_ == 0 || items_per_segment_ == 0)
+            throw std::invalid_argument("memory capacity and segment size must be greater than 0");
+    }
+
+    SpillingQueue(const SpillingQueue&) = delete;
+    SpillingQueue& operator=(const SpillingQueue&) = delete;
+
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return memory_.empty() && spilled_ == 0;
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return memory_.size() + spilled_;
+    }
+
+    // number of items currently stored in segment files
+    size_t spilled_size()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return spilled_;
+    }
+
+    // wakes all blocked consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            is_closed_ = true;
+        }
+        cv_q_not_empty_.notify_all();
+    }
+
+    bool is_closed()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return is_closed_;
+    }
+
+    // throws std::system_error when a segment file cannot be created
+    void push(const T& item)
+    {
+        bool has_waiting_consumers;
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+
+            if (is_closed_)
+                throw QueueClosed{};
+
+            if (spilled_ == 0 && memory_.size() < memory_capacity_)
+                memory_.push_back(item);
+            else
+                spill(item);
+
+            has_waiting_consumers = waiting_consumers_ > 0;
+        }
+
+        if (has_waiting_consumers)
+            cv_q_not_empty_.notify_one();
+    }
+
+    bool try_pop(T& item)
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return pop_front(item) == QueueStatus::success;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+
+        ++waiting_consumers_;
+        cv_q_not_empty_.wait(lk, [this] { return is_ready_to_pop(); });
+        --waiting_consumers_;
+
+        return pop_front(item);
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+
+        ++waiting_consumers_;
+        const bool is_ready = cv_q_not_empty_.wait_until(lk, timeout_time, [this] { return is_ready_to_pop(); });
+        --waiting_consumers_;
+
+        if (!is_ready)
+            return QueueStatus::timeout;
+
+        return pop_front(item);
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+};
+
+#endif // SPILLING_QUEUE_HPP
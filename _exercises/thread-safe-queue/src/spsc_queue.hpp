@@ -0,0 +1,137 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Lock-free ring queue for exactly one producer thread and one consumer thread
+template <typename T>
+class SpscQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> buffer_;
+
+    // consumer side - head_ is written only by the consumer
+    alignas(cache_line_size) std::atomic<size_t> head_{0};
+    size_t cached_tail_{0};
+
+    // producer side - tail_ is written only by the producer
+    alignas(cache_line_size) std::atomic<size_t> tail_{0};
+    size_t cached_head_{0};
+
+    static size_t round_up_to_power_of_2(size_t n)
+    {
+        size_t result = 1;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    T* slot(size_t index)
+    {
+        return reinterpret_cast<T*>(&buffer_[index & mask_]);
+    }
+
+    template <typename U>
+    bool try_push_item(U&& item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cached_head_ > mask_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_)
+                return false;
+        }
+
+        new (slot(tail)) T(std::forward<U>(item));
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+public:
+    // capacity is rounded up to a power of 2
+    explicit SpscQueue(size_t capacity = 1024)
+        : mask_{round_up_to_power_of_2(capacity) - 1}, buffer_{new Slot[mask_ + 1]}
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            slot(i)->~T();
+    }
+
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_push_item(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_item(std::move(item));
+    }
+
+    void push(const T& item)
+    {
+        while (!try_push_item(item))
+            std::this_thread::yield();
+    }
+
+    void push(T&& item)
+    {
+        while (!try_push_item(std::move(item)))
+            std::this_thread::yield();
+    }
+
+    bool try_pop(T& item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+                return false;
+        }
+
+        T* front = slot(head);
+        item = std::move(*front);
+        front->~T();
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    void pop(T& item)
+    {
+        while (!try_pop(item))
+            std::this_thread::yield();
+    }
+};
+
+#endif // SPSC_QUEUE_HPP
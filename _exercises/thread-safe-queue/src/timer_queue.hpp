@@ -0,0 +1,406 @@
+#ifndef TIMER_QUEUE_HPP
+#define TIMER_QUEUE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bit_utils.hpp"
+#include "queue_status.hpp"
+#include "thread_safe_queue.hpp"
+
+struct TimerId
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+// Releases scheduled items into a target queue (ThreadSafeQueue or any queue with push_range) when they become due.
+// Timers live in a hierarchical timing wheel - 4 levels of 64 slots, a slot of level L spans 64^L ticks - so schedule
+// and cancel are O(1). Timers further than 64^4 ticks away wait in the top level and are re-placed when it cascades.
+// A single timer thread sleeps until the next non-empty slot (found with per-level bitmaps), so it does not wake up
+// on every tick, and all items due at the same time are released with one push_range call.
+template <typename T, typename TargetQueue = ThreadSafeQueue<T>>
+class TimerQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = Clock::duration;
+
+private:
+    static constexpr int no_of_levels = 4;
+    static constexpr int slot_bits = 6;
+    static constexpr uint64_t slots_per_level = uint64_t{1} << slot_bits;
+    static constexpr uint64_t slot_mask = slots_per_level - 1;
+    static constexpr uint64_t wheel_range = uint64_t{1} << (no_of_levels * slot_bits);
+    static constexpr uint64_t no_tick = std::numeric_limits<uint64_t>::max();
+    static constexpr uint32_t nil = std::numeric_limits<uint32_t>::max();
+
+    struct Node
+    {
+        T item{};
+        uint64_t expiry_tick{};
+        uint32_t prev{nil};
+        uint32_t next{nil};
+        uint32_t generation{};
+        uint16_t level{};
+        uint16_t slot{};
+        bool is_scheduled{false};
+    };
+
+    struct Slot
+    {
+        uint32_t head{nil};
+        uint32_t tail{nil};
+    };
+
+    struct Level
+    {
+        std::array<Slot, slots_per_level> slots;
+        uint64_t occupied{0};
+    };
+
+    TargetQueue& target_;
+    const Duration tick_;
+    const Clock::time_point start_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_wake_;
+    std::array<Level, no_of_levels> levels_;
+    std::vector<Node> nodes_;
+    uint32_t free_head_{nil};
+    uint64_t current_tick_{0}; // last tick processed by the timer thread
+    uint64_t wake_tick_{no_tick}; // tick the timer thread sleeps until
+    std::vector<T> due_items_;
+    bool is_stopped_{false};
+
+    std::thread timer_thread_;
+
+    static uint64_t rotate_right(uint64_t bits, unsigned int shift)
+    {
+        return shift == 0 ? bits : (bits >> shift) | (bits << (64 - shift));
+    }
+
+    uint64_t now_tick() const
+    {
+        return static_cast<uint64_t>((Clock::now() - start_) / tick_);
+    }
+
+    uint64_t to_tick(Clock::time_point time) const
+    {
+        if (time <= start_)
+            return 0;
+
+        const auto elapsed = time - start_;
+        const auto ticks = static_cast<uint64_t>(elapsed / tick_);
+        return elapsed % tick_ == Duration::zero() ? ticks : ticks + 1;
+    }
+
+    Clock::time_point to_time(uint64_t tick) const
+    {
+        return start_ + tick_ * static_cast<Duration::rep>(tick);
+    }
+
+    uint32_t allocate_node()
+    {
+        if (free_head_ == nil)
+        {
+            nodes_.emplace_back();
+            return static_cast<uint32_t>(nodes_.size() - 1);
+        }
+
+        const uint32_t index = free_head_;
+        free_head_ = nodes_[index].next;
+        return index;
+    }
+
+    void free_node(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        node.is_scheduled = false;
+        ++node.generation;
+        node.next = free_head_;
+        free_head_ = index;
+    }
+
+    void release_node(uint32_t index)
+    {
+        due_items_.push_back(std::move(nodes_[index].item));
+        free_node(index);
+    }
+
+    void link(uint32_t index, int level, uint64_t slot)
+    {
+        Node& node = nodes_[index];
+        Slot& s = levels_[level].slots[slot];
+
+        node.level = static_cast<uint16_t>(level);
+        node.slot = static_cast<uint16_t>(slot);
+        node.prev = s.tail;
+        node.next = nil;
+
+        if (s.tail == nil)
+            s.head = index;
+        else
+            nodes_[s.tail].next = index;
+        s.tail = index;
+
+        levels_[level].occupied |= uint64_t{1} << slot;
+    }
+
+    void unlink(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        Slot& s = levels_[node.level].slots[node.slot];
+
+        if (node.prev == nil)
+            s.head = node.next;
+        else
+            nodes_[node.prev].next = node.next;
+
+        if (node.next == nil)
+            s.tail = node.prev;
+        else
+            nodes_[node.next].prev = node.prev;
+
+        if (s.head == nil)
+            levels_[node.level].occupied &= ~(uint64_t{1} << node.slot);
+    }
+
+    // returns the tick at which the timer thread has to look at the node again (no_tick if it is already due)
+    uint64_t place(uint32_t index)
+    {
+        const uint64_t expiry_tick = nodes_[index].expiry_tick;
+
+        if (expiry_tick <= current_tick_)
+        {
+            release_node(index);
+            return no_tick;
+        }
+
+        uint64_t delta = expiry_tick - current_tick_;
+        uint64_t placed_tick = expiry_tick;
+        if (delta >= wheel_range)
+        {
+            delta = wheel_range - 1;
+            placed_tick = current_tick_ + delta;
+        }
+
+        int level = 0;
+        while (delta >= (slots_per_level << (level * slot_bits)))
+            ++level;
+
+        const int shift = level * slot_bits;
+        link(index, level, (placed_tick >> shift) & slot_mask);
+
+        return (placed_tick >> shift) << shift;
+    }
+
+    // the earliest tick after current_tick_ at which a non-empty slot expires or cascades
+    uint64_t next_event_tick() const
+    {
+        uint64_t next = no_tick;
+
+        for (int level = 0; level < no_of_levels; ++level)
+        {
+            const uint64_t occupied = levels_[level].occupied;
+            if (occupied == 0)
+                continue;
+
+            const int shift = level * slot_bits;
+            const uint64_t position = current_tick_ >> shift;
+            const uint64_t distance = lowest_set_bit(rotate_right(occupied, (position + 1) & slot_mask)) + 1;
+
+            next = std::min(next, (position + distance) << shift);
+        }
+
+        return next;
+    }
+
+    void cascade(int level, uint64_t slot)
+    {
+        Slot& s = levels_[level].slots[slot];
+        uint32_t index = s.head;
+
+        s.head = s.tail = nil;
+        levels_[level].occupied &= ~(uint64_t{1} << slot);
+
+        while (index != nil)
+        {
+            const uint32_t next = nodes_[index].next;
+            place(index);
+            index = next;
+        }
+    }
+
+    void process_tick(uint64_t tick)
+    {
+        for (int level = no_of_levels - 1; level > 0; --level)
+        {
+            const int shift = level * slot_bits;
+            if ((tick & ((uint64_t{1} << shift) - 1)) == 0)
+                cascade(level, (tick >> shift) & slot_mask);
+        }
+
+        cascade(0, tick & slot_mask);
+    }
+
+    // must be called with mtx_ locked - collects due items in due_items_
+    void advance_to(uint64_t tick)
+    {
+        while (current_tick_ < tick)
+        {
+            const uint64_t next = next_event_tick();
+            if (next > tick)
+            {
+                current_tick_ = tick;
+                return;
+            }
+
+            current_tick_ = next;
+            process_tick(next);
+        }
+    }
+
+    void release(std::vector<T>& items)
+    {
+        try
+        {
+            target_.push_range(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+        }
+        catch (const QueueClosed&)
+        {
+            // items due after the target queue is closed are dropped
+        }
+
+        items.clear();
+    }
+
+    void run()
+    {
+        std::vector<T> items;
+        std::unique_lock<std::mutex> lk{mtx_};
+
+        while (!is_stopped_)
+        {
+            advance_to(now_tick());
+
+            if (!due_items_.empty())
+            {
+                items.swap(due_items_);
+                lk.unlock();
+                release(items);
+                lk.lock();
+                continue;
+            }
+
+            wake_tick_ = next_event_tick();
+            if (wake_tick_ == no_tick)
+                cv_wake_.wait(lk);
+            else
+                cv_wake_.wait_until(lk, to_time(wake_tick_));
+            wake_tick_ = 0;
+        }
+    }
+
+    template <typename U>
+    TimerId schedule(U&& item, Clock::time_point due_time)
+    {
+        std::vector<T> items;
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+
+            const uint32_t index = allocate_node();
+            Node& node = nodes_[index];
+            node.item = std::forward<U>(item);
+            node.expiry_tick = to_tick(due_time);
+            node.is_scheduled = true;
+            id = TimerId{index, node.generation};
+
+            const uint64_t event_tick = place(index);
+            if (event_tick < wake_tick_)
+                cv_wake_.notify_one();
+
+            items.swap(due_items_);
+        }
+
+        if (!items.empty())
+            release(items);
+
+        return id;
+    }
+
+public:
+    explicit TimerQueue(TargetQueue& target, Duration tick = std::chrono::milliseconds(1))
+        : target_{target}, tick_{tick}, start_{Clock::now()}, timer_thread_{[this] { run(); }}
+    {
+    }
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    // stops the timer thread - items that are not due yet are discarded
+    ~TimerQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_};
+            is_stopped_ = true;
+        }
+        cv_wake_.notify_one();
+        timer_thread_.join();
+    }
+
+    // an item is released not earlier than at due_time and at most one tick later (if the timer thread is not delayed)
+    TimerId schedule_at(const T& item, Clock::time_point due_time)
+    {
+        return schedule(item, due_time);
+    }
+
+    TimerId schedule_at(T&& item, Clock::time_point due_time)
+    {
+        return schedule(std::move(item), due_time);
+    }
+
+    template <typename Rep, typename Period>
+    TimerId schedule_after(const T& item, const std::chrono::duration<Rep, Period>& delay)
+    {
+        return schedule(item, Clock::now() + delay);
+    }
+
+    template <typename Rep, typename Period>
+    TimerId schedule_after(T&& item, const std::chrono::duration<Rep, Period>& delay)
+    {
+        return schedule(std::move(item), Clock::now() + delay);
+    }
+
+    // returns false if the item was already released or cancelled
+    bool cancel(TimerId id)
+    {
+        std::lock_guard<std::mutex> lk{mtx_};
+
+        if (id.index >= nodes_.size())
+            return false;
+
+        Node& node = nodes_[id.index];
+        if (!node.is_scheduled || node.generation != id.generation)
+            return false;
+
+        unlink(id.index);
+        node.item = T{};
+        free_node(id.index);
+
+        return true;
+    }
+};
+
+#endif // TIMER_QUEUE_HPP
@@ -0,0 +1,184 @@
+#ifndef TWO_LOCK_QUEUE_HPP
+#define TWO_LOCK_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "queue_status.hpp"
+
+// Linked queue with a dummy node and separate head & tail locks (Michael & Scott two-lock queue).
+// Producers take only the tail lock and consumers only the head lock, so push and pop
+// run in parallel whenever the queue is not empty.
+template <typename T>
+class TwoLockQueue
+{
+    static constexpr size_t cache_line_size = 64;
+
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* item()
+        {
+            return reinterpret_cast<T*>(&storage);
+        }
+    };
+
+    alignas(cache_line_size) std::mutex mtx_head_;
+    Node* head_;
+    std::condition_variable cv_not_empty_;
+    std::atomic<int> waiting_consumers_{0};
+    std::atomic<bool> is_closed_{false};
+
+    alignas(cache_line_size) std::mutex mtx_tail_;
+    Node* tail_;
+
+    bool is_ready_to_pop() const
+    {
+        return head_->next.load(std::memory_order_acquire) != nullptr || is_closed_.load();
+    }
+
+    // must be called with mtx_head_ locked
+    QueueStatus pop_front(std::unique_lock<std::mutex>& lk, T& item)
+    {
+        Node* old_head = head_;
+        Node* new_head = old_head->next.load(std::memory_order_acquire);
+
+        if (new_head == nullptr)
+            return QueueStatus::closed;
+
+        item = std::move(*new_head->item());
+        new_head->item()->~T();
+        head_ = new_head;
+        lk.unlock();
+
+        delete old_head;
+
+        return QueueStatus::success;
+    }
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        Node* node = new Node;
+        try
+        {
+            new (node->item()) T(std::forward<U>(item));
+        }
+        catch (...)
+        {
+            delete node;
+            throw;
+        }
+
+        {
+            // close() sets the flag under the tail lock - a consumer that sees the queue closed sees every linked node
+            std::unique_lock<std::mutex> lk{mtx_tail_};
+            if (is_closed_.load())
+            {
+                lk.unlock();
+                node->item()->~T();
+                delete node;
+                throw QueueClosed{};
+            }
+
+            tail_->next.store(node, std::memory_order_release);
+            tail_ = node;
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting_consumers_.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_head_};
+            }
+            cv_not_empty_.notify_one();
+        }
+    }
+
+public:
+    TwoLockQueue() : head_{new Node}, tail_{head_}
+    {
+    }
+
+    TwoLockQueue(const TwoLockQueue&) = delete;
+    TwoLockQueue& operator=(const TwoLockQueue&) = delete;
+
+    ~TwoLockQueue()
+    {
+        Node* node = head_->next.load(std::memory_order_relaxed);
+        delete head_;
+
+        while (node)
+        {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            node->item()->~T();
+            delete node;
+            node = next;
+        }
+    }
+
+    bool empty()
+    {
+        std::lock_guard<std::mutex> lk{mtx_head_};
+        return head_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    // wakes all blocked consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_tail_};
+            is_closed_.store(true);
+        }
+        {
+            std::lock_guard<std::mutex> lk{mtx_head_};
+        }
+        cv_not_empty_.notify_all();
+    }
+
+    bool is_closed() const
+    {
+        return is_closed_.load();
+    }
+
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    bool try_pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk{mtx_head_};
+        return pop_front(lk, item) == QueueStatus::success;
+    }
+
+    QueueStatus pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk{mtx_head_};
+
+        if (!is_ready_to_pop())
+        {
+            waiting_consumers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv_not_empty_.wait(lk, [this] { return is_ready_to_pop(); });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        return pop_front(lk, item);
+    }
+};
+
+#endif // TWO_LOCK_QUEUE_HPP
@@ -0,0 +1,170 @@
+#ifndef WAIT_POLICIES_HPP
+#define WAIT_POLICIES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// Wait policies decide what a consumer does before it parks on a condition variable:
+//  - spin(is_ready) runs without the queue lock and may return early when is_ready() becomes true
+//  - park(wait) wraps the blocking condition variable wait
+
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+struct BlockingWait
+{
+    template <typename Predicate>
+    void spin(Predicate&&)
+    {
+    }
+
+    template <typename Park>
+    void park(Park&& wait)
+    {
+        wait();
+    }
+};
+
+class SpinThenParkWait
+{
+    unsigned int spin_count_;
+
+public:
+    explicit SpinThenParkWait(unsigned int spin_count = 4000) : spin_count_{spin_count}
+    {
+    }
+
+    template <typename Predicate>
+    void spin(Predicate&& is_ready)
+    {
+        for (unsigned int i = 0; i < spin_count_ && !is_ready(); ++i)
+            cpu_relax();
+    }
+
+    template <typename Park>
+    void park(Park&& wait)
+    {
+        wait();
+    }
+};
+
+class YieldWait
+{
+    unsigned int yield_count_;
+
+public:
+    explicit YieldWait(unsigned int yield_count = 100) : yield_count_{yield_count}
+    {
+    }
+
+    template <typename Predicate>
+    void spin(Predicate&& is_ready)
+    {
+        for (unsigned int i = 0; i < yield_count_ && !is_ready(); ++i)
+            std::this_thread::yield();
+    }
+
+    template <typename Park>
+    void park(Park&& wait)
+    {
+        wait();
+    }
+};
+
+// Spins for up to twice the recently observed wait time (moving average of spin and park times).
+// Short hand-offs keep it spinning, waits longer than max_spin_time switch spinning off
+// until parked waits get short again.
+class AdaptiveWait
+{
+public:
+    using Duration = std::chrono::nanoseconds;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int spins_per_clock_check = 64;
+
+    Duration max_spin_time_;
+    std::atomic<Duration::rep> average_wait_ns_;
+
+    static Duration min_spin_time()
+    {
+        return std::chrono::microseconds(1);
+    }
+
+    void record_wait(Duration wait_time)
+    {
+        // exponential moving average with weight 1/8 - races between consumers only lose samples
+        auto average = average_wait_ns_.load(std::memory_order_relaxed);
+        average += (wait_time.count() - average) / 8;
+        average_wait_ns_.store(average, std::memory_order_relaxed);
+    }
+
+public:
+    explicit AdaptiveWait(Duration max_spin_time = std::chrono::microseconds(50))
+        : max_spin_time_{max_spin_time}, average_wait_ns_{max_spin_time.count() / 4}
+    {
+    }
+
+    AdaptiveWait(const AdaptiveWait& other)
+        : max_spin_time_{other.max_spin_time_}, average_wait_ns_{other.average_wait_ns_.load(std::memory_order_relaxed)}
+    {
+    }
+
+    Duration spin_budget() const
+    {
+        auto budget = Duration{2 * average_wait_ns_.load(std::memory_order_relaxed)};
+
+        if (budget > max_spin_time_)
+            return Duration::zero();
+
+        return budget > min_spin_time() ? budget : min_spin_time();
+    }
+
+    template <typename Predicate>
+    void spin(Predicate&& is_ready)
+    {
+        const auto budget = spin_budget();
+        if (budget == Duration::zero() || is_ready())
+            return;
+
+        const auto start = Clock::now();
+        while (true)
+        {
+            for (int i = 0; i < spins_per_clock_check; ++i)
+            {
+                if (is_ready())
+                {
+                    record_wait(Clock::now() - start);
+                    return;
+                }
+                cpu_relax();
+            }
+
+            if (Clock::now() - start >= budget)
+                return;
+        }
+    }
+
+    template <typename Park>
+    void park(Park&& wait)
+    {
+        const auto start = Clock::now();
+        wait();
+        record_wait(Clock::now() - start);
+    }
+};
+
+#endif // WAIT_POLICIES_HPP
@@ -0,0 +1,89 @@
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <new>
+
+#include "catch.hpp"
+
+#include "recycling_allocator.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+namespace
+{
+    atomic<size_t> allocation_counter{0};
+}
+
+void* operator new(size_t size)
+{
+    allocation_counter.fetch_add(1, memory_order_relaxed);
+
+    if (void* ptr = malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+namespace
+{
+    template <typename Queue>
+    void push_pop_cycles(Queue& q)
+    {
+        int item;
+
+        for (int i = 0; i < 10'000; ++i)
+        {
+            q.push(i);
+            q.pop(item);
+        }
+
+        for (int burst = 0; burst < 10; ++burst)
+        {
+            for (int i = 0; i < 2'000; ++i)
+                q.push(i);
+
+            for (int i = 0; i < 2'000; ++i)
+                q.pop(item);
+        }
+    }
+}
+
+TEST_CASE("ThreadSafeQueue with RecyclingAllocator does not allocate in steady state")
+{
+    ThreadSafeQueue<int, deque<int, RecyclingAllocator<int>>> q;
+
+    push_pop_cycles(q); // warm-up
+
+    const size_t allocations_before = allocation_counter.load();
+    push_pop_cycles(q);
+    const size_t allocations_after = allocation_counter.load();
+
+    REQUIRE(allocations_after - allocations_before == 0);
+}
+
+TEST_CASE("BlockCache keeps at most max_cached_blocks blocks per size")
+{
+    BlockCache cache{4};
+
+    for (int i = 0; i < 10; ++i)
+        cache.deallocate(::operator new(32), 32);
+    for (int i = 0; i < 10; ++i)
+        cache.deallocate(::operator new(64), 64);
+
+    REQUIRE(cache.cached_blocks() == 8);
+
+    void* block = cache.allocate(32);
+    REQUIRE(cache.cached_blocks() == 7);
+    cache.deallocate(block, 32);
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "bounded_thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("BoundedThreadSafeQueue")
+{
+    BoundedThreadSafeQueue<int> q{2};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.capacity() == 2);
+    }
+
+    SECTION("capacity must be greater than zero")
+    {
+        REQUIRE_THROWS_AS(BoundedThreadSafeQueue<int>{0}, std::invalid_argument);
+    }
+
+    SECTION("pops items in FIFO order across wrap-around")
+    {
+        int item;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            q.push(i);
+            q.push(i + 100);
+
+            REQUIRE(q.try_pop(item));
+            REQUIRE(item == i);
+            REQUIRE(q.try_pop(item));
+            REQUIRE(item == i + 100);
+        }
+
+        REQUIRE(q.empty());
+    }
+
+    SECTION("try_push fails when queue is full")
+    {
+        REQUIRE(q.try_push(1));
+        REQUIRE(q.try_push(2));
+        REQUIRE(q.full());
+        REQUIRE(q.try_push(3) == false);
+    }
+
+    SECTION("producer waits when pushing to full queue")
+    {
+        q.push({1, 2});
+
+        chrono::high_resolution_clock::time_point t1;
+
+        thread thd{[&q, &t1] {
+            q.push(3);
+            t1 = chrono::high_resolution_clock::now();
+        }};
+
+        this_thread::sleep_for(200ms);
+        chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+        int item;
+        q.pop(item);
+        thd.join();
+
+        REQUIRE(t1 >= t2);
+        REQUIRE(item == 1);
+        q.pop(item);
+        REQUIRE(item == 2);
+        q.pop(item);
+        REQUIRE(item == 3);
+    }
+
+    SECTION("client waits when poping from empty")
+    {
+        int item;
+
+        thread thd{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(50ms);
+        q.push(42);
+        thd.join();
+
+        REQUIRE(item == 42);
+    }
+}
+
+TEST_CASE("BoundedThreadSafeQueue destroys items left in the buffer")
+{
+    auto item = make_shared<int>(1);
+
+    {
+        BoundedThreadSafeQueue<shared_ptr<int>> q{4};
+        q.push(item);
+        q.push(item);
+
+        REQUIRE(item.use_count() == 3);
+    }
+
+    REQUIRE(item.use_count() == 1);
+}
+
+TEST_CASE("BoundedThreadSafeQueue - close")
+{
+    BoundedThreadSafeQueue<int> q{4};
+
+    SECTION("wakes all blocked consumers")
+    {
+        vector<QueueStatus> statuses(3);
+        vector<thread> consumers;
+
+        for (auto& status : statuses)
+            consumers.emplace_back([&q, &status] {
+                int item;
+                status = q.pop(item);
+            });
+
+        this_thread::sleep_for(50ms);
+        q.close();
+
+        for (auto& thd : consumers)
+            thd.join();
+
+        REQUIRE(all_of(statuses.begin(), statuses.end(), [](QueueStatus s) { return s == QueueStatus::closed; }));
+    }
+
+    SECTION("items pushed before close can still be popped")
+    {
+        q.push(1);
+        q.close();
+
+        int item;
+        REQUIRE(q.pop(item) == QueueStatus::success);
+        REQUIRE(item == 1);
+        REQUIRE(q.pop(item) == QueueStatus::closed);
+    }
+
+    SECTION("push to closed queue throws")
+    {
+        q.close();
+
+        REQUIRE(q.is_closed());
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+
+    SECTION("wakes blocked producer which throws")
+    {
+        q.push({1, 2, 3, 4});
+
+        bool has_thrown = false;
+
+        thread producer{[&q, &has_thrown] {
+            try
+            {
+                q.push(5);
+            }
+            catch (const QueueClosed&)
+            {
+                has_thrown = true;
+            }
+        }};
+
+        this_thread::sleep_for(50ms);
+        q.close();
+        producer.join();
+
+        REQUIRE(has_thrown);
+    }
+
+    SECTION("pop_for returns timeout when no item arrives")
+    {
+        int item;
+        REQUIRE(q.pop_for(item, 10ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_until returns item pushed before deadline")
+    {
+        thread producer{[&q] {
+            this_thread::sleep_for(10ms);
+            q.push(42);
+        }};
+
+        int item = 0;
+        auto status = q.pop_until(item, chrono::steady_clock::now() + 10s);
+        producer.join();
+
+        REQUIRE(status == QueueStatus::success);
+        REQUIRE(item == 42);
+    }
+}
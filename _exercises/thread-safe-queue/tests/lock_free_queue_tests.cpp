@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "hazard_pointers.hpp"
+#include "lock_free_queue.hpp"
+
+using namespace std;
+
+namespace
+{
+    struct Tracked
+    {
+        bool* is_deleted;
+
+        explicit Tracked(bool* is_deleted) : is_deleted{is_deleted}
+        {
+        }
+
+        ~Tracked()
+        {
+            if (is_deleted)
+                *is_deleted = true;
+        }
+    };
+
+    void retire_unprotected_nodes(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            retire_node(new Tracked{nullptr});
+    }
+}
+
+TEST_CASE("HazardPointer")
+{
+    const size_t enough_to_trigger_scan = HazardPointerDomain::instance().scan_threshold();
+
+    bool is_deleted = false;
+    atomic<Tracked*> src{new Tracked{&is_deleted}};
+
+    SECTION("protected node is not deleted")
+    {
+        HazardPointer hp;
+        Tracked* node = hp.protect(src);
+        REQUIRE(node == src.load());
+
+        src.store(nullptr);
+        retire_node(node);
+        retire_unprotected_nodes(enough_to_trigger_scan);
+
+        REQUIRE(is_deleted == false);
+
+        hp.reset();
+        retire_unprotected_nodes(enough_to_trigger_scan);
+
+        REQUIRE(is_deleted == true);
+    }
+
+    SECTION("unprotected node is deleted")
+    {
+        retire_node(src.exchange(nullptr));
+        retire_unprotected_nodes(enough_to_trigger_scan);
+
+        REQUIRE(is_deleted == true);
+    }
+
+    SECTION("thread can own only limited number of hazard pointers")
+    {
+        vector<unique_ptr<HazardPointer>> hps;
+        for (size_t i = 0; i < HazardPointerDomain::slots_per_thread; ++i)
+            hps.emplace_back(new HazardPointer);
+
+        REQUIRE_THROWS_AS(HazardPointer{}, std::logic_error);
+
+        delete src.exchange(nullptr);
+    }
+}
+
+TEST_CASE("HazardPointerDomain - records for any number of threads")
+{
+    const int no_of_threads = 256;
+
+    // every thread keeps its record until all threads have used the queue
+    auto use_queue_at_once = [no_of_threads](LockFreeQueue<int>& q) {
+        atomic<int> no_of_ready{0};
+
+        vector<thread> threads;
+        for (int i = 0; i < no_of_threads; ++i)
+            threads.emplace_back([&q, &no_of_ready, no_of_threads, i] {
+                q.push(i);
+                int item;
+                q.try_pop(item);
+
+                ++no_of_ready;
+                while (no_of_ready < no_of_threads)
+                    this_thread::yield();
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+    };
+
+    LockFreeQueue<int> q;
+    auto& domain = HazardPointerDomain::instance();
+
+    use_queue_at_once(q);
+    const size_t no_of_records = domain.record_count();
+    REQUIRE(no_of_records >= static_cast<size_t>(no_of_threads));
+
+    SECTION("records of exited threads are reused")
+    {
+        use_queue_at_once(q);
+        REQUIRE(domain.record_count() == no_of_records);
+    }
+
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("LockFreeQueue")
+{
+    LockFreeQueue<string> q;
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("try_pop on empty queue returns false")
+    {
+        string item;
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("items are popped in FIFO order")
+    {
+        q.push("one");
+        q.push("two");
+        string three = "three";
+        q.push(three);
+
+        vector<string> popped;
+        string item;
+        while (q.try_pop(item))
+            popped.push_back(item);
+
+        REQUIRE(popped == (vector<string>{"one", "two", "three"}));
+        REQUIRE(q.empty());
+    }
+
+    SECTION("destructor destroys items left in queue")
+    {
+        q.push(string(100, 'a'));
+        q.push(string(100, 'b'));
+    }
+}
+
+TEST_CASE("LockFreeQueue with many producers and consumers")
+{
+    const int no_of_producers = 4;
+    const int no_of_consumers = 4;
+    const int items_per_producer = 20'000;
+
+    LockFreeQueue<int> q;
+
+    vector<thread> threads;
+    vector<long long> sums(no_of_consumers);
+
+    for (int c = 0; c < no_of_consumers; ++c)
+        threads.emplace_back([&q, &sums, c] {
+            int item;
+            for (int i = 0; i < no_of_producers * items_per_producer / no_of_consumers; ++i)
+            {
+                q.pop(item);
+                sums[c] += item;
+            }
+        });
+
+    for (int p = 0; p < no_of_producers; ++p)
+        threads.emplace_back([&q] {
+            for (int i = 1; i <= items_per_producer; ++i)
+                q.push(i);
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    long long total = 0;
+    for (auto sum : sums)
+        total += sum;
+
+    REQUIRE(total == no_of_producers * static_cast<long long>(items_per_producer) * (items_per_producer + 1) / 2);
+    REQUIRE(q.empty());
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "mpmc_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("MpmcQueue")
+{
+    MpmcQueue<int> q{4};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.capacity() == 4);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+        REQUIRE(q.empty());
+    }
+
+    SECTION("try_push fails when queue is full")
+    {
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(q.try_push(i));
+
+        REQUIRE(q.try_push(4) == false);
+    }
+
+    SECTION("blocked consumer is woken by push")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(50ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("blocked producer is woken by pop")
+    {
+        for (int i = 0; i < 4; ++i)
+            q.push(i);
+
+        thread producer{[&q] { q.push(4); }};
+
+        this_thread::sleep_for(50ms);
+        int item;
+        q.pop(item);
+        producer.join();
+
+        REQUIRE(item == 0);
+    }
+
+    SECTION("many producers and consumers transfer every item exactly once")
+    {
+        const int no_of_producers = 4;
+        const int no_of_consumers = 4;
+        const int items_per_producer = 10'000;
+
+        vector<atomic<int>> received(no_of_producers * items_per_producer);
+        for (auto& r : received)
+            r = 0;
+
+        vector<thread> threads;
+
+        for (int c = 0; c < no_of_consumers; ++c)
+            threads.emplace_back([&] {
+                int item;
+                for (int i = 0; i < items_per_producer * no_of_producers / no_of_consumers; ++i)
+                {
+                    q.pop(item);
+                    received[item]++;
+                }
+            });
+
+        for (int p = 0; p < no_of_producers; ++p)
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < items_per_producer; ++i)
+                    q.push(p * items_per_producer + i);
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(all_of(received.begin(), received.end(), [](const atomic<int>& r) { return r == 1; }));
+    }
+}
+
+TEST_CASE("MpmcQueue destroys items left in the buffer")
+{
+    auto item = make_shared<int>(1);
+
+    {
+        MpmcQueue<shared_ptr<int>> q{4};
+        q.push(item);
+        q.push(item);
+
+        REQUIRE(item.use_count() == 3);
+    }
+
+    REQUIRE(item.use_count() == 1);
+}
+
+TEST_CASE("MpmcQueue - close")
+{
+    MpmcQueue<int> q{4};
+
+    SECTION("wakes all blocked consumers")
+    {
+        vector<QueueStatus> statuses(3);
+        vector<thread> consumers;
+
+        for (auto& status : statuses)
+            consumers.emplace_back([&q, &status] {
+                int item;
+                status = q.pop(item);
+            });
+
+        this_thread::sleep_for(50ms);
+        q.close();
+
+        for (auto& thd : consumers)
+            thd.join();
+
+        REQUIRE(all_of(statuses.begin(), statuses.end(), [](QueueStatus s) { return s == QueueStatus::closed; }));
+    }
+
+    SECTION("items pushed before close can still be popped")
+    {
+        q.push(1);
+        q.close();
+
+        int item;
+        REQUIRE(q.pop(item) == QueueStatus::success);
+        REQUIRE(item == 1);
+        REQUIRE(q.pop(item) == QueueStatus::closed);
+    }
+
+    SECTION("push to closed queue throws")
+    {
+        q.close();
+
+        REQUIRE(q.is_closed());
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+
+    SECTION("every successful push racing with close is popped")
+    {
+        for (int round = 0; round < 200; ++round)
+        {
+            MpmcQueue<int> racing_q{64};
+            atomic<int> pushed{0};
+            atomic<int> popped{0};
+            vector<thread> threads;
+
+            for (int p = 0; p < 3; ++p)
+                threads.emplace_back([&] {
+                    try
+                    {
+                        while (true)
+                        {
+                            racing_q.push(1);
+                            ++pushed;
+                        }
+                    }
+                    catch (const QueueClosed&)
+                    {
+                    }
+                });
+
+            for (int c = 0; c < 2; ++c)
+                threads.emplace_back([&] {
+                    int item;
+                    while (racing_q.pop(item) == QueueStatus::success)
+                        ++popped;
+                });
+
+            this_thread::yield();
+            racing_q.close();
+
+            for (auto& thd : threads)
+                thd.join();
+
+            REQUIRE(popped == pushed);
+            REQUIRE(racing_q.empty());
+        }
+    }
+
+    SECTION("pop_for returns timeout when no item arrives")
+    {
+        int item;
+        REQUIRE(q.pop_for(item, 10ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_until returns item pushed before deadline")
+    {
+        thread producer{[&q] {
+            this_thread::sleep_for(10ms);
+            q.push(42);
+        }};
+
+        int item = 0;
+        auto status = q.pop_until(item, chrono::steady_clock::now() + 10s);
+        producer.join();
+
+        REQUIRE(status == QueueStatus::success);
+        REQUIRE(item == 42);
+    }
+}
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "multicast_ring.hpp"
+
+using namespace std;
+
+TEST_CASE("MulticastRing")
+{
+    MulticastRing<int> ring{5};
+    auto& consumer = ring.add_consumer();
+
+    SECTION("capacity is rounded up to power of 2")
+    {
+        REQUIRE(ring.capacity() == 8);
+    }
+
+    SECTION("try_consume on empty ring returns 0")
+    {
+        REQUIRE(consumer.try_consume([](const int&) {}) == 0);
+    }
+
+    SECTION("try_publish fails when slowest consumer is a full ring behind")
+    {
+        for (int i = 0; i < 8; ++i)
+            REQUIRE(ring.try_publish([i](int& slot) { slot = i; }));
+
+        REQUIRE(ring.try_publish([](int& slot) { slot = 8; }) == false);
+
+        REQUIRE(consumer.try_consume([](const int&) {}, 1) == 1);
+        REQUIRE(ring.try_publish([](int& slot) { slot = 8; }));
+    }
+
+    SECTION("items are consumed in place in order")
+    {
+        ring.push(1);
+        ring.push(2);
+        ring.push(3);
+
+        vector<int> seen;
+        vector<const int*> addresses;
+        REQUIRE(consumer.try_consume([&](const int& item) {
+            seen.push_back(item);
+            addresses.push_back(&item);
+        }) == 3);
+
+        REQUIRE(seen == (vector<int>{1, 2, 3}));
+        REQUIRE(addresses[1] == addresses[0] + 1);
+    }
+
+    SECTION("consume returns 0 after close when all items are processed")
+    {
+        ring.push(1);
+        ring.close();
+
+        REQUIRE(consumer.consume([](const int&) {}) == 1);
+        REQUIRE(consumer.consume([](const int&) {}) == 0);
+        REQUIRE_THROWS_AS(ring.push(2), QueueClosed);
+    }
+}
+
+TEST_CASE("MulticastRing delivers every item to every consumer")
+{
+    const int no_of_items = 100'000;
+    const int no_of_consumers = 3;
+
+    MulticastRing<int> ring{64};
+
+    vector<MulticastRing<int>::Consumer*> consumers;
+    for (int i = 0; i < no_of_consumers; ++i)
+        consumers.push_back(&ring.add_consumer());
+
+    vector<long long> sums(no_of_consumers);
+    vector<bool> in_order(no_of_consumers, true);
+    vector<thread> threads;
+    for (int i = 0; i < no_of_consumers; ++i)
+        threads.emplace_back([&, i] {
+            int expected = 0;
+            while (consumers[i]->consume([&](const int& item) {
+                in_order[i] = in_order[i] && item == expected++;
+                sums[i] += item;
+            }) > 0)
+            {
+            }
+        });
+
+    for (int i = 0; i < no_of_items; ++i)
+        ring.push(i);
+    ring.close();
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const long long expected_sum = static_cast<long long>(no_of_items) * (no_of_items - 1) / 2;
+    for (int i = 0; i < no_of_consumers; ++i)
+    {
+        REQUIRE(in_order[i]);
+        REQUIRE(sums[i] == expected_sum);
+    }
+}
+
+TEST_CASE("MulticastRing consumer sees items only after its dependencies processed them")
+{
+    const int no_of_items = 20'000;
+
+    struct Event
+    {
+        int value;
+    };
+
+    MulticastRing<Event> ring{16};
+    auto& persist = ring.add_consumer();
+    auto& journal = ring.add_consumer();
+    auto& replicate = ring.add_consumer({&persist, &journal});
+
+    atomic<int> persisted{0};
+    atomic<int> journaled{0};
+    bool is_ordered = true;
+    int replicated = 0;
+
+    thread persist_thd{[&] {
+        while (persist.consume([&](const Event&) { persisted.fetch_add(1); }) > 0)
+        {
+        }
+    }};
+
+    thread journal_thd{[&] {
+        while (journal.consume([&](const Event&) { journaled.fetch_add(1); }) > 0)
+        {
+        }
+    }};
+
+    thread replicate_thd{[&] {
+        while (replicate.consume([&](const Event& e) {
+            ++replicated;
+            is_ordered = is_ordered && e.value < persisted.load() && e.value < journaled.load();
+        }) > 0)
+        {
+        }
+    }};
+
+    for (int i = 0; i < no_of_items; ++i)
+        ring.publish([i](Event& e) { e.value = i; });
+    ring.close();
+
+    persist_thd.join();
+    journal_thd.join();
+    replicate_thd.join();
+
+    REQUIRE(is_ordered);
+    REQUIRE(replicated == no_of_items);
+}
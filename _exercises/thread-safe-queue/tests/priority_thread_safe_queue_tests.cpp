@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "priority_thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("lowest_set_bit")
+{
+    REQUIRE(lowest_set_bit(1) == 0);
+    REQUIRE(lowest_set_bit(0b10100) == 2);
+    REQUIRE(lowest_set_bit(uint64_t{1} << 63) == 63);
+}
+
+TEST_CASE("PriorityThreadSafeQueue")
+{
+    PriorityThreadSafeQueue<int, 3> q{1000};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("pops the most urgent item first")
+    {
+        q.push(20, 2);
+        q.push(10, 1);
+        q.push(0, 0);
+        q.push(11, 1);
+
+        vector<int> popped;
+        int item;
+        while (q.try_pop(item))
+            popped.push_back(item);
+
+        REQUIRE(popped == (vector<int>{0, 10, 11, 20}));
+        REQUIRE(q.empty());
+    }
+
+    SECTION("push without priority uses default level")
+    {
+        q.push(20, 2);
+        q.push(10);
+        q.push(0, 0);
+
+        int item;
+        q.pop(item);
+        REQUIRE(item == 0);
+        q.pop(item);
+        REQUIRE(item == 10);
+    }
+
+    SECTION("push with invalid priority throws")
+    {
+        REQUIRE_THROWS_AS(q.push(1, 3), std::out_of_range);
+    }
+
+    SECTION("try_pop on empty queue returns false")
+    {
+        int item;
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("pop_for times out on empty queue")
+    {
+        int item;
+        REQUIRE(q.pop_for(item, 10ms) == QueueStatus::timeout);
+    }
+
+    SECTION("close wakes blocked consumer and items can still be drained")
+    {
+        q.push(1, 2);
+
+        int item;
+        REQUIRE(q.pop(item) == QueueStatus::success);
+
+        QueueStatus status = QueueStatus::success;
+        thread consumer{[&q, &status] {
+            int item;
+            status = q.pop(item);
+        }};
+
+        this_thread::sleep_for(50ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(status == QueueStatus::closed);
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+}
+
+TEST_CASE("PriorityThreadSafeQueue ages starved levels")
+{
+    const unsigned int aging_threshold = 4;
+    PriorityThreadSafeQueue<int, 2> q{aging_threshold};
+
+    q.push(-1, 1);
+    for (int i = 0; i < 100; ++i)
+        q.push(i, 0);
+
+    vector<int> popped;
+    int item;
+    while (q.try_pop(item))
+        popped.push_back(item);
+
+    auto batch_item = find(popped.begin(), popped.end(), -1);
+    REQUIRE(batch_item - popped.begin() == aging_threshold);
+}
+
+TEST_CASE("PriorityThreadSafeQueue with many producers and consumers")
+{
+    const int no_of_producers = 4;
+    const int items_per_producer = 10'000;
+
+    PriorityThreadSafeQueue<int, 4> q;
+
+    vector<thread> producers;
+    for (int p = 0; p < no_of_producers; ++p)
+        producers.emplace_back([&q, p] {
+            for (int i = 1; i <= items_per_producer; ++i)
+                q.push(i, p);
+        });
+
+    vector<long long> sums(2);
+    vector<thread> consumers;
+    for (auto& sum : sums)
+        consumers.emplace_back([&q, &sum] {
+            int item;
+            while (q.pop(item) == QueueStatus::success)
+                sum += item;
+        });
+
+    for (auto& thd : producers)
+        thd.join();
+    q.close();
+    for (auto& thd : consumers)
+        thd.join();
+
+    const long long expected = no_of_producers * static_cast<long long>(items_per_producer) * (items_per_producer + 1) / 2;
+    REQUIRE(sums[0] + sums[1] == expected);
+}
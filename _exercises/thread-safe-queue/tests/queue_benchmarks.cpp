@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "lock_free_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "queue_selector.hpp"
+#include "sharded_queue.hpp"
+#include "spsc_queue.hpp"
+#include "thread_safe_queue.hpp"
+#include "two_lock_queue.hpp"
+#include "wait_policies.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    constexpr int no_of_items = 100'000;
+
+    template <typename Queue>
+    int transfer_one_to_one(Queue& q, int count)
+    {
+        int sum = 0;
+
+        thread consumer{[&q, &sum, count] {
+            int item = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                q.pop(item);
+                sum += item;
+            }
+        }};
+
+        for (int i = 0; i < count; ++i)
+            q.push(1);
+
+        consumer.join();
+
+        return sum;
+    }
+
+    template <typename Queue>
+    int ping_pong(int count)
+    {
+        Queue requests;
+        Queue replies;
+
+        thread echo{[&requests, &replies] {
+            int item = 0;
+            while (requests.pop(item) == QueueStatus::success)
+                replies.push(item);
+        }};
+
+        int sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            requests.push(i);
+            int reply = 0;
+            replies.pop(reply);
+            sum += reply;
+        }
+
+        requests.close();
+        echo.join();
+
+        return sum;
+    }
+
+    template <typename Queue>
+    void transfer_many_to_many(Queue& q, unsigned int no_of_producers, unsigned int no_of_consumers, int count)
+    {
+        vector<thread> threads;
+
+        for (unsigned int c = 0; c < no_of_consumers; ++c)
+        {
+            int items_to_pop = count / no_of_consumers + (c < count % no_of_consumers ? 1 : 0);
+            threads.emplace_back([&q, items_to_pop] {
+                int item;
+                for (int i = 0; i < items_to_pop; ++i)
+                    q.pop(item);
+            });
+        }
+
+        for (unsigned int p = 0; p < no_of_producers; ++p)
+        {
+            int items_to_push = count / no_of_producers + (p < count % no_of_producers ? 1 : 0);
+            threads.emplace_back([&q, items_to_push] {
+                for (int i = 0; i < items_to_push; ++i)
+                    q.push(i);
+            });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+    }
+}
+
+TEST_CASE("SPSC transfer of 100k items", "[!benchmark]")
+{
+    BENCHMARK("ThreadSafeQueue")
+    {
+        ThreadSafeQueue<int> q;
+        return transfer_one_to_one(q, no_of_items);
+    };
+
+    BENCHMARK("SpscQueue")
+    {
+        SpscQueue<int> q{1024};
+        return transfer_one_to_one(q, no_of_items);
+    };
+}
+
+TEST_CASE("MPMC scaling - N producers x N consumers, 100k items", "[!benchmark]")
+{
+    const auto max_threads = max(thread::hardware_concurrency(), 1u);
+
+    for (unsigned int n = 1;; n = min(2 * n, max_threads))
+    {
+        BENCHMARK("ThreadSafeQueue - " + to_string(n) + "x" + to_string(n))
+        {
+            ThreadSafeQueue<int> q;
+            transfer_many_to_many(q, n, n, no_of_items);
+        };
+
+        BENCHMARK("MpmcQueue - " + to_string(n) + "x" + to_string(n))
+        {
+            MpmcQueue<int> q{1024};
+            transfer_many_to_many(q, n, n, no_of_items);
+        };
+
+        if (n == max_threads)
+            break;
+    }
+}
+
+TEST_CASE("Producer/consumer ratios - 100k items", "[!benchmark]")
+{
+    const pair<unsigned int, unsigned int> ratios[] = {{1, 1}, {4, 1}, {1, 4}};
+
+    for (const auto& ratio : ratios)
+    {
+        const auto no_of_producers = ratio.first;
+        const auto no_of_consumers = ratio.second;
+        const auto label = to_string(no_of_producers) + ":" + to_string(no_of_consumers);
+
+        BENCHMARK("ThreadSafeQueue - " + label)
+        {
+            ThreadSafeQueue<int> q;
+            transfer_many_to_many(q, no_of_producers, no_of_consumers, no_of_items);
+        };
+
+        BENCHMARK("TwoLockQueue - " + label)
+        {
+            TwoLockQueue<int> q;
+            transfer_many_to_many(q, no_of_producers, no_of_consumers, no_of_items);
+        };
+    }
+}
+
+TEST_CASE("Hand-off latency - 10k round trips", "[!benchmark]")
+{
+    const int no_of_round_trips = 10'000;
+
+    BENCHMARK("BlockingWait")
+    {
+        return ping_pong<ThreadSafeQueue<int, deque<int>, BlockingWait>>(no_of_round_trips);
+    };
+
+    BENCHMARK("SpinThenParkWait")
+    {
+        return ping_pong<ThreadSafeQueue<int, deque<int>, SpinThenParkWait>>(no_of_round_trips);
+    };
+
+    BENCHMARK("YieldWait")
+    {
+        return ping_pong<ThreadSafeQueue<int, deque<int>, YieldWait>>(no_of_round_trips);
+    };
+
+    BENCHMARK("AdaptiveWait")
+    {
+        return ping_pong<ThreadSafeQueue<int, deque<int>, AdaptiveWait>>(no_of_round_trips);
+    };
+}
+
+TEST_CASE("Fan-in - 32 producers x 2 consumers, 100k items", "[!benchmark]")
+{
+    BENCHMARK("ThreadSafeQueue")
+    {
+        ThreadSafeQueue<int> q;
+        transfer_many_to_many(q, 32, 2, no_of_items);
+    };
+
+    BENCHMARK("ShardedQueue")
+    {
+        ShardedQueue<int> q;
+        transfer_many_to_many(q, 32, 2, no_of_items);
+    };
+}
+
+// more runnable threads than cores - a thread preempted while holding the queue mutex stalls everybody else,
+// a preempted thread in LockFreeQueue delays only itself
+TEST_CASE("Oversubscribed - 4x more producers and consumers than cores, 100k items", "[!benchmark]")
+{
+    const auto no_of_threads = 4 * max(thread::hardware_concurrency(), 1u);
+
+    BENCHMARK("ThreadSafeQueue - " + to_string(no_of_threads) + "x" + to_string(no_of_threads))
+    {
+        ThreadSafeQueue<int> q;
+        transfer_many_to_many(q, no_of_threads, no_of_threads, no_of_items);
+    };
+
+    BENCHMARK("LockFreeQueue - " + to_string(no_of_threads) + "x" + to_string(no_of_threads))
+    {
+        LockFreeQueue<int> q;
+        transfer_many_to_many(q, no_of_threads, no_of_threads, no_of_items);
+    };
+}
+
+namespace
+{
+    void produce_into(vector<ThreadSafeQueue<int>>& queues, int count)
+    {
+        vector<thread> producers;
+        for (auto& q : queues)
+            producers.emplace_back([&q, count] {
+                for (int i = 0; i < count; ++i)
+                    q.push(i);
+                q.close();
+            });
+
+        for (auto& thd : producers)
+            thd.join();
+    }
+}
+
+TEST_CASE("Dispatch from 8 queues - 100k items", "[!benchmark]")
+{
+    const int no_of_queues = 8;
+
+    BENCHMARK("thread per queue")
+    {
+        vector<ThreadSafeQueue<int>> queues(no_of_queues);
+
+        vector<thread> consumers;
+        for (auto& q : queues)
+            consumers.emplace_back([&q] {
+                int item;
+                while (q.pop(item) == QueueStatus::success)
+                {
+                }
+            });
+
+        produce_into(queues, no_of_items / no_of_queues);
+
+        for (auto& thd : consumers)
+            thd.join();
+    };
+
+    BENCHMARK("QueueSelector")
+    {
+        vector<ThreadSafeQueue<int>> queues(no_of_queues);
+        QueueSelector selector;
+        for (auto& q : queues)
+            selector.add(q);
+
+        thread dispatcher{[&] {
+            int open_queues = no_of_queues;
+            while (open_queues > 0)
+            {
+                const auto index = selector.wait();
+                int item;
+                while (queues[index].try_pop(item))
+                {
+                }
+
+                if (queues[index].is_closed() && queues[index].empty())
+                {
+                    selector.remove(index);
+                    --open_queues;
+                }
+            }
+        }};
+
+        produce_into(queues, no_of_items / no_of_queues);
+
+        dispatcher.join();
+    };
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace
+{
+    // ThreadSafeQueue before notification elision - signals on every push
+    class AlwaysNotifyQueue
+    {
+        queue<int> q_;
+        mutex mtx_q_;
+        condition_variable cv_q_not_empty_;
+
+    public:
+        void push(int item)
+        {
+            {
+                lock_guard<mutex> lk{mtx_q_};
+                q_.push(item);
+            }
+            cv_q_not_empty_.notify_one();
+        }
+
+        QueueStatus pop(int& item)
+        {
+            unique_lock<mutex> lk{mtx_q_};
+            cv_q_not_empty_.wait(lk, [this] { return !q_.empty(); });
+            item = q_.front();
+            q_.pop();
+            return QueueStatus::success;
+        }
+    };
+
+    long context_switches()
+    {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_nvcsw + usage.ru_nivcsw;
+    }
+
+    // producers keep the queue non-empty, so consumers almost never have to park
+    template <typename Queue>
+    long context_switches_under_saturated_producers()
+    {
+        Queue q;
+        const int count = 1'000'000;
+
+        for (int i = 0; i < count / 2; ++i)
+            q.push(i);
+
+        const long before = context_switches();
+        transfer_many_to_many(q, 2, 1, count / 2);
+        const long after = context_switches();
+
+        int item;
+        for (int i = 0; i < count / 2; ++i)
+            q.pop(item);
+
+        return after - before;
+    }
+}
+
+// futex syscalls can be counted with: strace -f -c -e trace=futex thread_safe_queue_tests "Notification elision*"
+TEST_CASE("Notification elision - context switches with saturated producers", "[!benchmark]")
+{
+    const long always_notify = context_switches_under_saturated_producers<AlwaysNotifyQueue>();
+    const long elided = context_switches_under_saturated_producers<ThreadSafeQueue<int>>();
+
+    cout << "context switches (getrusage) - notify on every push: " << always_notify
+         << ", notify only parked consumers: " << elided << endl;
+}
+#endif
@@ -0,0 +1,115 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "queue_selector.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("QueueSelector")
+{
+    ThreadSafeQueue<string> control;
+    ThreadSafeQueue<int> data;
+
+    QueueSelector selector;
+    const auto control_index = selector.add(control);
+    const auto data_index = selector.add(data);
+
+    SECTION("reports queue that has an item")
+    {
+        data.push(1);
+        REQUIRE(selector.wait() == data_index);
+
+        int item;
+        REQUIRE(data.try_pop(item));
+
+        control.push("stop");
+        REQUIRE(selector.wait() == control_index);
+    }
+
+    SECTION("wait_for times out when all queues are empty")
+    {
+        REQUIRE((selector.wait_for(20ms) == QueueSelector::npos));
+    }
+
+    SECTION("blocked wait is woken up by push to any queue")
+    {
+        size_t ready_index = QueueSelector::npos;
+        thread dispatcher{[&] { ready_index = selector.wait(); }};
+
+        this_thread::sleep_for(50ms);
+        control.push("stop");
+        dispatcher.join();
+
+        REQUIRE(ready_index == control_index);
+    }
+
+    SECTION("closed queue is reported as ready")
+    {
+        data.close();
+        REQUIRE(selector.wait() == data_index);
+    }
+
+    SECTION("removed queue is not reported")
+    {
+        data.close();
+        selector.remove(data_index);
+
+        REQUIRE((selector.wait_for(20ms) == QueueSelector::npos));
+    }
+
+    SECTION("queues with items are reported round-robin")
+    {
+        control.push("a");
+        data.push(1);
+
+        REQUIRE(selector.wait() == control_index);
+        REQUIRE(selector.wait() == data_index);
+        REQUIRE(selector.wait() == control_index);
+    }
+}
+
+TEST_CASE("QueueSelector - one dispatcher serves many queues")
+{
+    const int no_of_queues = 4;
+    const int items_per_queue = 10'000;
+
+    vector<ThreadSafeQueue<int>> queues(no_of_queues);
+    QueueSelector selector;
+    for (auto& q : queues)
+        selector.add(q);
+
+    long long sum = 0;
+    thread dispatcher{[&] {
+        int open_queues = no_of_queues;
+        while (open_queues > 0)
+        {
+            const auto index = selector.wait();
+            int item;
+            if (queues[index].try_pop(item))
+                sum += item;
+            else if (queues[index].is_closed())
+            {
+                selector.remove(index);
+                --open_queues;
+            }
+        }
+    }};
+
+    vector<thread> producers;
+    for (auto& q : queues)
+        producers.emplace_back([&q] {
+            for (int i = 1; i <= items_per_queue; ++i)
+                q.push(i);
+            q.close();
+        });
+
+    for (auto& thd : producers)
+        thd.join();
+    dispatcher.join();
+
+    REQUIRE(sum == no_of_queues * static_cast<long long>(items_per_queue) * (items_per_queue + 1) / 2);
+}
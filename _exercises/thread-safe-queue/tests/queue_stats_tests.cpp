@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "queue_stats.hpp"
+#include "thread_safe_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("LatencyHistogram")
+{
+    SECTION("small values have exact buckets")
+    {
+        for (uint64_t value = 0; value < 8; ++value)
+            REQUIRE(LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(value)) == value);
+    }
+
+    SECTION("bucket upper bound is within 25% of a recorded value")
+    {
+        for (uint64_t value : {9ull, 100ull, 1'000ull, 123'456ull, 10'000'000'000ull})
+        {
+            const auto upper = LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(value));
+            REQUIRE(upper >= value);
+            REQUIRE(upper <= value + value / 4);
+        }
+    }
+
+    SECTION("percentiles")
+    {
+        LatencyHistogram histogram;
+        for (int i = 1; i <= 100; ++i)
+            histogram.record(chrono::nanoseconds(i));
+
+        LatencyHistogram::Snapshot snapshot;
+        histogram.add_to(snapshot);
+
+        REQUIRE(snapshot.count() == 100);
+        REQUIRE(snapshot.percentile(50) >= 50);
+        REQUIRE(snapshot.percentile(50) <= 55);
+        REQUIRE(snapshot.max() >= 100);
+    }
+}
+
+TEST_CASE("ThreadSafeQueue with QueueStats")
+{
+    ThreadSafeQueue<int, deque<int>, BlockingWait, QueueStats> q;
+
+    SECTION("counts pushes, pops and depth")
+    {
+        q.push({1, 2, 3});
+        int item;
+        q.pop(item);
+
+        auto stats = q.stats().snapshot();
+
+        REQUIRE(stats.pushes == 3);
+        REQUIRE(stats.pops == 1);
+        REQUIRE(stats.depth == 2);
+        REQUIRE(stats.high_water_mark == 3);
+        REQUIRE(stats.queued_time.count() == 1);
+    }
+
+    SECTION("records time consumers spend blocked")
+    {
+        thread consumer{[&q] {
+            int item;
+            q.pop(item);
+        }};
+
+        this_thread::sleep_for(20ms);
+        q.push(1);
+        consumer.join();
+
+        auto stats = q.stats().snapshot();
+
+        REQUIRE(stats.blocked_time.count() == 1);
+        REQUIRE(stats.blocked_time.max() >= static_cast<uint64_t>(chrono::nanoseconds(10ms).count()));
+    }
+
+    SECTION("snapshot can be dumped as JSON")
+    {
+        q.push(1);
+
+        auto json = q.stats().snapshot().to_json();
+
+        REQUIRE(json.find("\"pushes\":1") != string::npos);
+        REQUIRE(json.find("\"high_water_mark\":1") != string::npos);
+        REQUIRE(json.find("\"blocked_time_ns\":{\"count\":0") != string::npos);
+    }
+}
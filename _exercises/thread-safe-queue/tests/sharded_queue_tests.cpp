@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "sharded_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("ShardedQueue")
+{
+    ShardedQueue<int> q{4};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+        REQUIRE(q.no_of_lanes() == 4);
+    }
+
+    SECTION("items of single producer are popped in FIFO order")
+    {
+        for (int i = 0; i < 100; ++i)
+            q.push(i);
+
+        vector<int> popped;
+        int item;
+        while (q.try_pop(item))
+            popped.push_back(item);
+
+        REQUIRE(popped.size() == 100);
+        REQUIRE(is_sorted(popped.begin(), popped.end()));
+        REQUIRE(q.empty());
+    }
+
+    SECTION("close wakes blocked consumer")
+    {
+        QueueStatus status = QueueStatus::success;
+
+        thread consumer{[&q, &status] {
+            int item;
+            status = q.pop(item);
+        }};
+
+        this_thread::sleep_for(50ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(status == QueueStatus::closed);
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+
+    SECTION("every successful push racing with close is popped")
+    {
+        for (int round = 0; round < 200; ++round)
+        {
+            ShardedQueue<int> racing_q{2};
+            atomic<int> pushed{0};
+            atomic<int> popped{0};
+            vector<thread> threads;
+
+            for (int p = 0; p < 3; ++p)
+                threads.emplace_back([&] {
+                    try
+                    {
+                        while (true)
+                        {
+                            racing_q.push(1);
+                            ++pushed;
+                        }
+                    }
+                    catch (const QueueClosed&)
+                    {
+                    }
+                });
+
+            for (int c = 0; c < 2; ++c)
+                threads.emplace_back([&] {
+                    int item;
+                    while (racing_q.pop(item) == QueueStatus::success)
+                        ++popped;
+                });
+
+            this_thread::yield();
+            racing_q.close();
+
+            for (auto& thd : threads)
+                thd.join();
+
+            REQUIRE(popped == pushed);
+            REQUIRE(racing_q.empty());
+        }
+    }
+}
+
+TEST_CASE("ShardedQueue preserves per-producer FIFO order with many producers")
+{
+    const int no_of_producers = 8;
+    const int items_per_producer = 10'000;
+
+    ShardedQueue<pair<int, int>> q{3};
+
+    vector<thread> producers;
+    for (int p = 0; p < no_of_producers; ++p)
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < items_per_producer; ++i)
+                q.push(make_pair(p, i));
+        });
+
+    vector<int> last_seen(no_of_producers, -1);
+    bool is_fifo = true;
+
+    thread consumer{[&] {
+        pair<int, int> item;
+        for (int i = 0; i < no_of_producers * items_per_producer; ++i)
+        {
+            q.pop(item);
+            is_fifo = is_fifo && item.second == last_seen[item.first] + 1;
+            last_seen[item.first] = item.second;
+        }
+    }};
+
+    for (auto& thd : producers)
+        thd.join();
+    consumer.join();
+
+    REQUIRE(is_fifo);
+    REQUIRE(all_of(last_seen.begin(), last_seen.end(), [](int last) { return last == items_per_producer - 1; }));
+    REQUIRE(q.empty());
+}
@@ -0,0 +1,198 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "catch.hpp"
+
+#include "spilling_queue.hpp"
+
+using namespace std;
+
+namespace
+{
+    class TemporaryDirectory
+    {
+        string path_;
+
+    public:
+        TemporaryDirectory()
+        {
+            string pattern = "/tmp/spilling_queue_tests-XXXXXX";
+            if (!mkdtemp(&pattern[0]))
+                throw runtime_error("cannot create temporary directory");
+            path_ = pattern;
+        }
+
+        ~TemporaryDirectory()
+        {
+            rmdir(path_.c_str());
+        }
+
+        const string& path() const
+        {
+            return path_;
+        }
+
+        size_t no_of_files() const
+        {
+            size_t count = 0;
+            DIR* dir = opendir(path_.c_str());
+            while (dirent* entry = readdir(dir))
+                if (string{entry->d_name} != "." && string{entry->d_name} != "..")
+                    ++count;
+            closedir(dir);
+            return count;
+        }
+    };
+
+    struct Record
+    {
+        int id;
+        double value;
+    };
+}
+
+TEST_CASE("SpillingQueue")
+{
+    TemporaryDirectory dir;
+    SpillingQueue<Record> q{dir.path(), 4, 8};
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("keeps items in memory until memory capacity is reached")
+    {
+        for (int i = 0; i < 4; ++i)
+            q.push(Record{i, i * 0.5});
+
+        REQUIRE(q.spilled_size() == 0);
+        REQUIRE(dir.no_of_files() == 0);
+    }
+
+    SECTION("spills overflow to segment files")
+    {
+        for (int i = 0; i < 30; ++i)
+            q.push(Record{i, i * 0.5});
+
+        REQUIRE(q.size() == 30);
+        REQUIRE(q.spilled_size() == 26);
+        REQUIRE(dir.no_of_files() == 4);
+    }
+
+    SECTION("replays spilled items in FIFO order and deletes consumed segments")
+    {
+        for (int i = 0; i < 30; ++i)
+            q.push(Record{i, i * 0.5});
+
+        Record item;
+        for (int i = 0; i < 30; ++i)
+        {
+            REQUIRE(q.pop(item) == QueueStatus::success);
+            REQUIRE(item.id == i);
+            REQUIRE(item.value == i * 0.5);
+        }
+
+        REQUIRE(q.empty());
+        REQUIRE(dir.no_of_files() <= 1);
+    }
+
+    SECTION("items pushed while spilled items are replayed keep FIFO order")
+    {
+        int next_to_push = 0;
+        int next_to_pop = 0;
+        bool is_fifo = true;
+
+        for (int round = 0; round < 20; ++round)
+        {
+            for (int i = 0; i < 7; ++i)
+                q.push(Record{next_to_push++, 0.0});
+
+            Record item;
+            for (int i = 0; i < 5; ++i)
+            {
+                q.pop(item);
+                is_fifo = is_fifo && item.id == next_to_pop++;
+            }
+        }
+
+        Record item;
+        while (q.try_pop(item))
+            is_fifo = is_fifo && item.id == next_to_pop++;
+
+        REQUIRE(is_fifo);
+        REQUIRE(next_to_pop == next_to_push);
+    }
+
+    SECTION("close wakes blocked consumer")
+    {
+        QueueStatus status = QueueStatus::success;
+        thread consumer{[&q, &status] {
+            Record item;
+            status = q.pop(item);
+        }};
+
+        this_thread::sleep_for(50ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(status == QueueStatus::closed);
+        REQUIRE_THROWS_AS(q.push(Record{}), QueueClosed);
+    }
+}
+
+TEST_CASE("SpillingQueue removes segment files in destructor")
+{
+    TemporaryDirectory dir;
+
+    {
+        SpillingQueue<int> q{dir.path(), 16, 16};
+        for (int i = 0; i < 100; ++i)
+            q.push(i);
+
+        REQUIRE(dir.no_of_files() > 0);
+    }
+
+    REQUIRE(dir.no_of_files() == 0);
+}
+
+TEST_CASE("SpillingQueue throws when segment file cannot be created")
+{
+    SpillingQueue<int> q{"/nonexistent-directory", 1, 16};
+    q.push(1);
+
+    REQUIRE_THROWS_AS(q.push(2), std::system_error);
+}
+
+TEST_CASE("SpillingQueue with slow consumer")
+{
+    const int no_of_items = 50'000;
+
+    TemporaryDirectory dir;
+    SpillingQueue<int> q{dir.path(), 128, 1024};
+
+    long long sum = 0;
+    thread consumer{[&] {
+        int item;
+        while (q.pop(item) == QueueStatus::success)
+            sum += item;
+    }};
+
+    for (int i = 1; i <= no_of_items; ++i)
+        q.push(i);
+    q.close();
+
+    consumer.join();
+
+    REQUIRE(sum == static_cast<long long>(no_of_items) * (no_of_items + 1) / 2);
+    REQUIRE(dir.no_of_files() <= 1);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "spsc_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("SpscQueue")
+{
+    SpscQueue<int> q{3};
+
+    SECTION("capacity is rounded up to power of 2")
+    {
+        REQUIRE(q.capacity() == 4);
+    }
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+    }
+
+    SECTION("try_push fails when queue is full")
+    {
+        for (int i = 0; i < 4; ++i)
+            REQUIRE(q.try_push(i));
+
+        REQUIRE(q.try_push(4) == false);
+    }
+
+    SECTION("transfers all items between producer and consumer threads")
+    {
+        const int count = 100'000;
+
+        vector<int> received;
+        received.reserve(count);
+
+        thread consumer{[&q, &received, count] {
+            int item;
+            for (int i = 0; i < count; ++i)
+            {
+                q.pop(item);
+                received.push_back(item);
+            }
+        }};
+
+        for (int i = 0; i < count; ++i)
+            q.push(i);
+
+        consumer.join();
+
+        vector<int> expected(count);
+        iota(expected.begin(), expected.end(), 0);
+        REQUIRE(received == expected);
+    }
+}
+
+TEST_CASE("SpscQueue destroys items left in the buffer")
+{
+    auto item = make_shared<int>(1);
+
+    {
+        SpscQueue<shared_ptr<int>> q{4};
+        q.push(item);
+        q.push(item);
+
+        REQUIRE(item.use_count() == 3);
+    }
+
+    REQUIRE(item.use_count() == 1);
+}
@@ -1,7 +1,14 @@
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <queue>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "catch.hpp"
 
@@ -87,4 +94,190 @@ TEST_CASE("ThreadSafeQueue")
 
         REQUIRE(none_of(items.begin(), items.end(), [](int x) { return x == 0; }));
     }
+
+    SECTION("push_range pushes all items in order")
+    {
+        vector<int> items = {1, 2, 3};
+        tsq.push_range(items.begin(), items.end());
+
+        vector<int> popped;
+        REQUIRE(tsq.pop_bulk(back_inserter(popped), 10) == 3);
+        REQUIRE(popped == items);
+        REQUIRE(tsq.empty());
+    }
+
+    SECTION("pop_bulk pops at most max_n items")
+    {
+        tsq.push({1, 2, 3});
+
+        vector<int> popped;
+        REQUIRE(tsq.pop_bulk(back_inserter(popped), 2) == 2);
+        REQUIRE(popped == vector<int>{1, 2});
+        REQUIRE(tsq.empty() == false);
+    }
+
+    SECTION("pop_bulk waits for items")
+    {
+        vector<int> popped;
+
+        thread thd{[&tsq, &popped] { tsq.pop_bulk(back_inserter(popped), 10); }};
+
+        this_thread::sleep_for(50ms);
+        tsq.push(1);
+        thd.join();
+
+        REQUIRE(popped == vector<int>{1});
+    }
+}
+
+TEST_CASE("ThreadSafeQueue - push_bulk moves items into the queue")
+{
+    ThreadSafeQueue<unique_ptr<int>> tsq;
+
+    vector<unique_ptr<int>> items;
+    items.push_back(make_unique<int>(1));
+    items.push_back(make_unique<int>(2));
+
+    tsq.push_bulk(move(items));
+
+    REQUIRE(items.empty());
+
+    unique_ptr<int> item;
+    tsq.pop(item);
+    REQUIRE(*item == 1);
+    tsq.pop(item);
+    REQUIRE(*item == 2);
+}
+
+TEST_CASE("ThreadSafeQueue - move-only and non-default-constructible items")
+{
+    SECTION("emplace constructs item in place")
+    {
+        ThreadSafeQueue<pair<string, int>> q;
+        q.emplace("one", 1);
+
+        auto item = q.try_pop();
+        REQUIRE(item.has_value());
+        REQUIRE(*item == make_pair("one"s, 1));
+    }
+
+    SECTION("try_pop returns nullopt when queue is empty")
+    {
+        ThreadSafeQueue<int> q;
+        REQUIRE(q.try_pop() == nullopt);
+    }
+
+    SECTION("pop returns items by value and nullopt after close")
+    {
+        struct NoDefault
+        {
+            explicit NoDefault(int v) : value{v}
+            {
+            }
+
+            int value;
+        };
+
+        ThreadSafeQueue<NoDefault> q;
+        q.emplace(1);
+        q.close();
+
+        auto item = q.pop();
+        REQUIRE(item.has_value());
+        REQUIRE(item->value == 1);
+        REQUIRE(q.pop().has_value() == false);
+    }
+
+    SECTION("packaged_task can be passed through the queue")
+    {
+        ThreadSafeQueue<packaged_task<int()>> q;
+
+        packaged_task<int()> task{[] { return 42; }};
+        auto result = task.get_future();
+        q.push(move(task));
+
+        thread worker{[&q] {
+            auto task = q.pop();
+            (*task)();
+        }};
+
+        REQUIRE(result.get() == 42);
+        worker.join();
+    }
+
+    SECTION("pop_bulk moves items out of the queue")
+    {
+        ThreadSafeQueue<unique_ptr<int>> q;
+        q.emplace(new int{1});
+        q.emplace(new int{2});
+
+        vector<unique_ptr<int>> popped;
+        REQUIRE(q.pop_bulk(back_inserter(popped), 10) == 2);
+        REQUIRE(*popped[1] == 2);
+    }
+}
+
+TEST_CASE("ThreadSafeQueue - close")
+{
+    ThreadSafeQueue<int> q;
+
+    SECTION("wakes all blocked consumers")
+    {
+        vector<QueueStatus> statuses(3);
+        vector<thread> consumers;
+
+        for (auto& status : statuses)
+            consumers.emplace_back([&q, &status] {
+                int item;
+                status = q.pop(item);
+            });
+
+        this_thread::sleep_for(50ms);
+        q.close();
+
+        for (auto& thd : consumers)
+            thd.join();
+
+        REQUIRE(all_of(statuses.begin(), statuses.end(), [](QueueStatus s) { return s == QueueStatus::closed; }));
+    }
+
+    SECTION("items pushed before close can still be popped")
+    {
+        q.push(1);
+        q.close();
+
+        int item;
+        REQUIRE(q.pop(item) == QueueStatus::success);
+        REQUIRE(item == 1);
+        REQUIRE(q.pop(item) == QueueStatus::closed);
+    }
+
+    SECTION("push to closed queue throws")
+    {
+        q.close();
+
+        REQUIRE(q.is_closed());
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+
+    SECTION("pop_for returns timeout when no item arrives")
+    {
+        int item;
+        REQUIRE(q.pop_for(item, 10ms) == QueueStatus::timeout);
+    }
+
+    SECTION("pop_until returns item pushed before deadline")
+    {
+        thread producer{[&q] {
+            this_thread::sleep_for(10ms);
+            q.push(42);
+        }};
+
+        int item = 0;
+        auto status = q.pop_until(item, chrono::steady_clock::now() + 10s);
+        producer.join();
+
+        REQUIRE(status == QueueStatus::success);
+        REQUIRE(item == 42);
+    }
 }
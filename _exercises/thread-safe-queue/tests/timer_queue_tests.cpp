@@ -0,0 +1,126 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "timer_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("TimerQueue")
+{
+    ThreadSafeQueue<int> q;
+    TimerQueue<int> timers{q};
+
+    SECTION("releases item into target queue when it is due")
+    {
+        const auto start = chrono::steady_clock::now();
+        timers.schedule_after(42, 50ms);
+
+        int item;
+        REQUIRE(q.pop(item) == QueueStatus::success);
+        REQUIRE(item == 42);
+        REQUIRE(chrono::steady_clock::now() - start >= 50ms);
+    }
+
+    SECTION("releases items in order of due time")
+    {
+        timers.schedule_after(3, 60ms);
+        timers.schedule_after(1, 20ms);
+        timers.schedule_after(2, 40ms);
+
+        vector<int> released(3);
+        for (auto& item : released)
+            q.pop(item);
+
+        REQUIRE(released == (vector<int>{1, 2, 3}));
+    }
+
+    SECTION("item with due time in the past is released immediately")
+    {
+        timers.schedule_at(1, chrono::steady_clock::now() - 1s);
+
+        int item;
+        REQUIRE(q.pop_for(item, 1s) == QueueStatus::success);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("cancelled item is not released")
+    {
+        auto id = timers.schedule_after(1, 30ms);
+        timers.schedule_after(2, 60ms);
+
+        REQUIRE(timers.cancel(id) == true);
+        REQUIRE(timers.cancel(id) == false);
+
+        int item;
+        q.pop(item);
+        REQUIRE(item == 2);
+        REQUIRE(q.empty());
+    }
+
+    SECTION("cancel of released item returns false")
+    {
+        auto id = timers.schedule_after(1, 10ms);
+
+        int item;
+        q.pop(item);
+
+        REQUIRE(timers.cancel(id) == false);
+    }
+}
+
+TEST_CASE("TimerQueue cascades timers from higher wheel levels")
+{
+    ThreadSafeQueue<int> q;
+    TimerQueue<int> timers{q, 10us}; // 64 ticks = 640us, 64^2 ticks = ~41ms, 64^3 ticks = ~2.6s
+
+    timers.schedule_after(3, 150ms);
+    timers.schedule_after(2, 45ms);
+    timers.schedule_after(1, 2ms);
+    auto cancelled = timers.schedule_after(0, 100ms);
+    REQUIRE(timers.cancel(cancelled));
+
+    vector<int> released(3);
+    for (auto& item : released)
+        REQUIRE(q.pop_for(item, 1s) == QueueStatus::success);
+
+    REQUIRE(released == (vector<int>{1, 2, 3}));
+}
+
+TEST_CASE("TimerQueue with many timers")
+{
+    const int no_of_timers = 10'000;
+
+    ThreadSafeQueue<int> q;
+    TimerQueue<int> timers{q, 100us};
+
+    vector<TimerId> ids;
+    for (int i = 0; i < no_of_timers; ++i)
+        ids.push_back(timers.schedule_after(i, chrono::microseconds(i * 10)));
+
+    int cancelled = 0;
+    for (int i = no_of_timers / 2; i < no_of_timers; i += 2)
+        cancelled += timers.cancel(ids[i]);
+
+    int released = 0;
+    int item;
+    while (q.pop_for(item, 200ms) == QueueStatus::success)
+        ++released;
+
+    REQUIRE(released + cancelled == no_of_timers);
+}
+
+TEST_CASE("TimerQueue releases timers beyond the wheel range")
+{
+    ThreadSafeQueue<int> q;
+    TimerQueue<int> timers{q, 10ns}; // 64^4 ticks = ~168ms
+
+    const auto start = chrono::steady_clock::now();
+    timers.schedule_after(1, 250ms);
+
+    int item;
+    REQUIRE(q.pop_for(item, 2s) == QueueStatus::success);
+    REQUIRE(chrono::steady_clock::now() - start >= 250ms);
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "two_lock_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("TwoLockQueue")
+{
+    TwoLockQueue<int> q;
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(q.empty() == true);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        q.push(1);
+        q.push(2);
+
+        int item;
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 1);
+        REQUIRE(q.try_pop(item));
+        REQUIRE(item == 2);
+        REQUIRE(q.try_pop(item) == false);
+        REQUIRE(q.empty());
+    }
+
+    SECTION("blocked consumer is woken by push")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(50ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("close wakes blocked consumer")
+    {
+        QueueStatus status = QueueStatus::success;
+
+        thread consumer{[&q, &status] {
+            int item;
+            status = q.pop(item);
+        }};
+
+        this_thread::sleep_for(50ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(status == QueueStatus::closed);
+        REQUIRE_THROWS_AS(q.push(1), QueueClosed);
+    }
+
+    SECTION("every successful push racing with close is popped")
+    {
+        for (int round = 0; round < 200; ++round)
+        {
+            TwoLockQueue<int> racing_q;
+            atomic<int> pushed{0};
+            atomic<int> popped{0};
+            vector<thread> threads;
+
+            for (int p = 0; p < 3; ++p)
+                threads.emplace_back([&] {
+                    try
+                    {
+                        while (true)
+                        {
+                            racing_q.push(1);
+                            ++pushed;
+                        }
+                    }
+                    catch (const QueueClosed&)
+                    {
+                    }
+                });
+
+            for (int c = 0; c < 2; ++c)
+                threads.emplace_back([&] {
+                    int item;
+                    while (racing_q.pop(item) == QueueStatus::success)
+                        ++popped;
+                });
+
+            this_thread::yield();
+            racing_q.close();
+
+            for (auto& thd : threads)
+                thd.join();
+
+            REQUIRE(popped == pushed);
+            REQUIRE(racing_q.empty());
+        }
+    }
+
+    SECTION("many producers and consumers transfer every item exactly once")
+    {
+        const int no_of_producers = 4;
+        const int no_of_consumers = 4;
+        const int items_per_producer = 10'000;
+
+        vector<atomic<int>> received(no_of_producers * items_per_producer);
+        for (auto& r : received)
+            r = 0;
+
+        vector<thread> threads;
+
+        for (int c = 0; c < no_of_consumers; ++c)
+            threads.emplace_back([&] {
+                int item;
+                for (int i = 0; i < items_per_producer * no_of_producers / no_of_consumers; ++i)
+                {
+                    q.pop(item);
+                    received[item]++;
+                }
+            });
+
+        for (int p = 0; p < no_of_producers; ++p)
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < items_per_producer; ++i)
+                    q.push(p * items_per_producer + i);
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(all_of(received.begin(), received.end(), [](const atomic<int>& r) { return r == 1; }));
+    }
+}
+
+TEST_CASE("TwoLockQueue destroys items left in the queue")
+{
+    auto item = make_shared<int>(1);
+
+    {
+        TwoLockQueue<shared_ptr<int>> q;
+        q.push(item);
+        q.push(item);
+
+        REQUIRE(item.use_count() == 3);
+    }
+
+    REQUIRE(item.use_count() == 1);
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <deque>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "thread_safe_queue.hpp"
+#include "wait_policies.hpp"
+
+using namespace std;
+
+TEMPLATE_TEST_CASE("ThreadSafeQueue hands items over with wait policy", "", BlockingWait, SpinThenParkWait, YieldWait, AdaptiveWait)
+{
+    ThreadSafeQueue<int, deque<int>, TestType> q;
+
+    SECTION("consumer waits for an item")
+    {
+        int item = 0;
+
+        thread consumer{[&q, &item] { q.pop(item); }};
+
+        this_thread::sleep_for(20ms);
+        q.push(42);
+        consumer.join();
+
+        REQUIRE(item == 42);
+    }
+
+    SECTION("close wakes a waiting consumer")
+    {
+        QueueStatus status = QueueStatus::success;
+
+        thread consumer{[&q, &status] {
+            int item;
+            status = q.pop(item);
+        }};
+
+        this_thread::sleep_for(20ms);
+        q.close();
+        consumer.join();
+
+        REQUIRE(status == QueueStatus::closed);
+    }
+
+    SECTION("ping-pong between two threads")
+    {
+        ThreadSafeQueue<int, deque<int>, TestType> replies;
+
+        thread echo{[&q, &replies] {
+            int item;
+            while (q.pop(item) == QueueStatus::success)
+                replies.push(item);
+        }};
+
+        int sum = 0;
+        for (int i = 1; i <= 1000; ++i)
+        {
+            q.push(i);
+            int reply;
+            replies.pop(reply);
+            sum += reply;
+        }
+
+        q.close();
+        echo.join();
+
+        REQUIRE(sum == 500500);
+    }
+}
+
+TEST_CASE("AdaptiveWait")
+{
+    AdaptiveWait wait_policy{chrono::microseconds(100)};
+
+    SECTION("short waits keep spinning enabled")
+    {
+        for (int i = 0; i < 32; ++i)
+            wait_policy.park([] {});
+
+        REQUIRE(wait_policy.spin_budget() > AdaptiveWait::Duration::zero());
+    }
+
+    SECTION("long waits switch spinning off")
+    {
+        for (int i = 0; i < 32; ++i)
+            wait_policy.park([] { this_thread::sleep_for(chrono::microseconds(500)); });
+
+        REQUIRE(wait_policy.spin_budget() == AdaptiveWait::Duration::zero());
+    }
+
+    SECTION("spin returns as soon as item is ready")
+    {
+        int probes = 0;
+        wait_policy.spin([&probes] { return ++probes == 3; });
+
+        REQUIRE(probes == 3);
+    }
+}
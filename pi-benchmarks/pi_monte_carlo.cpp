@@ -14,6 +14,10 @@
 #include <thread>
 #include <new>
 
+#include "parallel_algorithms.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_thread_pool.hpp"
+
 using namespace std;
 
 template <typename Real>
@@ -269,6 +273,44 @@ double calc_pi_async_with_futures(counter_t throws)
     return total_hits / throws * 4;
 }
 
+// pool versions - threads are started once and reused by every calculation
+
+template <typename Pool>
+double calc_pi_parallel_reduce(Pool& pool, counter_t throws)
+{
+    const counter_t hits = parallel_reduce(pool, IndexRange<counter_t>{0, throws}, counter_t{0},
+        [](const IndexRange<counter_t>& chunk) { return calc_hits(chunk.size()); },
+        plus<counter_t>{});
+
+    return (static_cast<double>(hits) / throws) * 4;
+}
+
+template <typename Pool>
+double calc_pi_parallel_for(Pool& pool, counter_t throws)
+{
+    atomic<counter_t> hits{};
+
+    parallel_for(pool, IndexRange<counter_t>{0, throws}, 0, [&hits](const IndexRange<counter_t>& chunk) {
+        hits.fetch_add(calc_hits(chunk.size()), std::memory_order_relaxed);
+    });
+
+    return (static_cast<double>(hits) / throws) * 4;
+}
+
+template <typename Pool>
+double calc_pi_parallel_transform(Pool& pool, counter_t throws)
+{
+    const counter_t no_of_chunks = 8 * (pool.size() + 1);
+
+    vector<counter_t> throws_per_chunk(no_of_chunks, throws / no_of_chunks);
+    throws_per_chunk.back() += throws % no_of_chunks;
+
+    vector<counter_t> hits(no_of_chunks);
+    parallel_transform(pool, throws_per_chunk.begin(), throws_per_chunk.end(), hits.begin(), &calc_hits, 1);
+
+    return (accumulate(hits.begin(), hits.end(), 0.0) / throws) * 4;
+}
+
 constexpr int N = 1'000'000;
 
 TEST_CASE("Monte Carlo Pi")
@@ -300,4 +342,34 @@ TEST_CASE("Monte Carlo Pi")
     BENCHMARK("futures") {
         return calc_pi_async_with_futures(N);
     };
+
+    const auto hardware_threads_count = max(thread::hardware_concurrency(), 1u);
+
+    ThreadPool<> thread_pool{hardware_threads_count};
+    WorkStealingThreadPool work_stealing_pool{hardware_threads_count};
+
+    BENCHMARK("parallel_reduce - ThreadPool") {
+        return calc_pi_parallel_reduce(thread_pool, N);
+    };
+
+    BENCHMARK("parallel_reduce - WorkStealingThreadPool") {
+        return calc_pi_parallel_reduce(work_stealing_pool, N);
+    };
+
+    BENCHMARK("parallel_for - WorkStealingThreadPool") {
+        return calc_pi_parallel_for(work_stealing_pool, N);
+    };
+
+    BENCHMARK("parallel_transform - WorkStealingThreadPool") {
+        return calc_pi_parallel_transform(work_stealing_pool, N);
+    };
+}
+
+TEST_CASE("Monte Carlo Pi - pool algorithms")
+{
+    WorkStealingThreadPool pool{4};
+
+    REQUIRE(calc_pi_parallel_reduce(pool, N) == Approx(3.1415).epsilon(0.01));
+    REQUIRE(calc_pi_parallel_for(pool, N) == Approx(3.1415).epsilon(0.01));
+    REQUIRE(calc_pi_parallel_transform(pool, N) == Approx(3.1415).epsilon(0.01));
 }
@@ -0,0 +1,1084 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_MAIN
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_thread_safe_queue.hpp"
+#include "cpu_topology.hpp"
+#include "elastic_thread_pool.hpp"
+#include "numa_thread_pool.hpp"
+#include "parallel_algorithms.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_thread_pool.hpp"
+
+using namespace std;
+
+// counts all heap allocations of the process - every form of global operator new and delete is replaced
+static atomic<size_t> allocation_count{0};
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+    // kept out of line - once inlined into operator delete, the compiler pairs operator new with free
+    // and warns about mismatched allocation functions
+    NOINLINE void* counted_allocate(size_t size, size_t alignment) noexcept
+    {
+        ++allocation_count;
+
+        if (size == 0)
+            size = 1;
+
+        if (alignment == 0)
+            return malloc(size);
+
+#if defined(_WIN32)
+        return _aligned_malloc(size, alignment);
+#else
+        return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    NOINLINE void counted_deallocate(void* ptr, size_t alignment) noexcept
+    {
+#if defined(_WIN32)
+        if (alignment != 0)
+        {
+            _aligned_free(ptr);
+            return;
+        }
+#endif
+        (void)alignment;
+        free(ptr);
+    }
+
+    void* counted_allocate_or_throw(size_t size, size_t alignment)
+    {
+        if (void* ptr = counted_allocate(size, alignment))
+            return ptr;
+
+        throw bad_alloc{};
+    }
+}
+
+void* operator new(size_t size)
+{
+    return counted_allocate_or_throw(size, 0);
+}
+
+void* operator new[](size_t size)
+{
+    return counted_allocate_or_throw(size, 0);
+}
+
+void* operator new(size_t size, align_val_t alignment)
+{
+    return counted_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, align_val_t alignment)
+{
+    return counted_allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept
+{
+    return counted_allocate(size, 0);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept
+{
+    return counted_allocate(size, 0);
+}
+
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept
+{
+    return counted_allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept
+{
+    return counted_allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete(void* ptr, align_val_t alignment) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* ptr, align_val_t alignment) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr, size_t, align_val_t alignment) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* ptr, size_t, align_val_t alignment) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr, const nothrow_t&) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete[](void* ptr, const nothrow_t&) noexcept
+{
+    counted_deallocate(ptr, 0);
+}
+
+void operator delete(void* ptr, align_val_t alignment, const nothrow_t&) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* ptr, align_val_t alignment, const nothrow_t&) noexcept
+{
+    counted_deallocate(ptr, static_cast<size_t>(alignment));
+}
+
+namespace
+{
+    template <typename F>
+    size_t count_allocations(F f)
+    {
+        const size_t before = allocation_count.load();
+        f();
+        return allocation_count.load() - before;
+    }
+
+    // a task waits for its subtask by running other pending tasks - blocking on get() would starve the pool
+    template <typename Pool, typename Future>
+    auto help_until_ready(Pool& pool, Future& f)
+    {
+        while (f.wait_for(0s) != future_status::ready)
+        {
+            if (!pool.run_pending_task())
+                this_thread::yield();
+        }
+
+        return f.get();
+    }
+
+    long long fib_seq(int n)
+    {
+        return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+    }
+
+    template <typename Pool>
+    long long fib(Pool& pool, int n)
+    {
+        const int cutoff = 20;
+
+        if (n < cutoff)
+            return fib_seq(n);
+
+        auto f = pool.submit([&pool, n] { return fib(pool, n - 1); });
+        const long long second = fib(pool, n - 2);
+
+        return help_until_ready(pool, f) + second;
+    }
+
+    template <typename Pool, typename It>
+    void quicksort(Pool& pool, It first, It last)
+    {
+        const ptrdiff_t cutoff = 2048;
+
+        if (last - first < cutoff)
+        {
+            sort(first, last);
+            return;
+        }
+
+        const auto pivot = *(first + (last - first) / 2);
+        It middle1 = partition(first, last, [pivot](const auto& x) { return x < pivot; });
+        It middle2 = partition(middle1, last, [pivot](const auto& x) { return !(pivot < x); });
+
+        auto f = pool.submit([&pool, first, middle1] { quicksort(pool, first, middle1); });
+        quicksort(pool, middle2, last);
+
+        help_until_ready(pool, f);
+    }
+
+    vector<int> random_ints(size_t size)
+    {
+        vector<int> data(size);
+        mt19937 gen{42};
+        uniform_int_distribution<int> distr;
+        generate(data.begin(), data.end(), [&] { return distr(gen); });
+        return data;
+    }
+
+    vector<unsigned int> thread_counts()
+    {
+        const auto max_threads = max(thread::hardware_concurrency(), 1u);
+
+        vector<unsigned int> counts;
+        for (unsigned int n = 1; n < max_threads; n *= 2)
+            counts.push_back(n);
+        counts.push_back(max_threads);
+
+        return counts;
+    }
+}
+
+TEST_CASE("allocation counting covers array, aligned and nothrow new")
+{
+    struct alignas(64) CacheLine
+    {
+        char data[64];
+    };
+
+    // volatile sinks - otherwise a new/delete pair may be elided
+    static int* volatile ints;
+    static CacheLine* volatile lines;
+
+    REQUIRE(count_allocations([] { ints = new int[10]; delete[] ints; }) == 1);
+    REQUIRE(count_allocations([] { lines = new CacheLine; delete lines; }) == 1);
+    REQUIRE(count_allocations([] { lines = new CacheLine[4]; delete[] lines; }) == 1);
+    REQUIRE(count_allocations([] { ints = new (nothrow) int{42}; delete ints; }) == 1);
+}
+
+TEST_CASE("fork/join pools compute correct results")
+{
+    SECTION("fib")
+    {
+        WorkStealingThreadPool ws_pool{4};
+        REQUIRE(fib(ws_pool, 27) == fib_seq(27));
+
+        ThreadPool<> shared_pool{4};
+        REQUIRE(fib(shared_pool, 27) == fib_seq(27));
+    }
+
+    SECTION("quicksort")
+    {
+        auto data = random_ints(100'000);
+
+        WorkStealingThreadPool pool{4};
+        quicksort(pool, data.begin(), data.end());
+
+        REQUIRE(is_sorted(data.begin(), data.end()));
+    }
+
+    SECTION("tasks still submit subtasks while the pool shuts down")
+    {
+        vector<long long> results(8);
+
+        auto submit_fibs = [&results](auto& pool) {
+            for (auto& result : results)
+                pool.submit([&pool, &result] { result = fib(pool, 24); });
+        };
+
+        {
+            ThreadPool<> pool{2};
+            submit_fibs(pool);
+            pool.shutdown();
+        }
+        REQUIRE(all_of(results.begin(), results.end(), [](long long r) { return r == fib_seq(24); }));
+
+        fill(results.begin(), results.end(), 0);
+        {
+            WorkStealingThreadPool pool{2};
+            submit_fibs(pool);
+        }
+        REQUIRE(all_of(results.begin(), results.end(), [](long long r) { return r == fib_seq(24); }));
+    }
+}
+
+TEST_CASE("parallel fib(32)")
+{
+    const int n = 32;
+
+    for (auto no_of_threads : thread_counts())
+    {
+        BENCHMARK("shared queue - threads: " + to_string(no_of_threads))
+        {
+            ThreadPool<> pool{no_of_threads};
+            return fib(pool, n);
+        };
+
+        BENCHMARK("work stealing - threads: " + to_string(no_of_threads))
+        {
+            WorkStealingThreadPool pool{no_of_threads};
+            return fib(pool, n);
+        };
+    }
+}
+
+TEST_CASE("parallel quicksort - 4M ints")
+{
+    const auto data = random_ints(4'000'000);
+
+    for (auto no_of_threads : thread_counts())
+    {
+        BENCHMARK_ADVANCED("shared queue - threads: " + to_string(no_of_threads))(Catch::Benchmark::Chronometer meter)
+        {
+            ThreadPool<> pool{no_of_threads};
+            auto unsorted = data;
+            meter.measure([&] { quicksort(pool, unsorted.begin(), unsorted.end()); });
+        };
+
+        BENCHMARK_ADVANCED("work stealing - threads: " + to_string(no_of_threads))(Catch::Benchmark::Chronometer meter)
+        {
+            WorkStealingThreadPool pool{no_of_threads};
+            auto unsorted = data;
+            meter.measure([&] { quicksort(pool, unsorted.begin(), unsorted.end()); });
+        };
+    }
+}
+
+TEST_CASE("task wrapping - allocations")
+{
+    // allocations of packaged_task itself (shared state, result) are the same in both cases and are not counted
+    packaged_task<int()> pt{[] { return 42; }};
+    auto result = pt.get_future();
+
+    SECTION("std::function with shared packaged_task")
+    {
+        function<void()> task;
+
+        auto allocations = count_allocations([&] {
+            auto shared_pt = make_shared<packaged_task<int()>>(move(pt));
+            task = [shared_pt] { (*shared_pt)(); };
+        });
+
+        REQUIRE(allocations == 2); // control block of shared_ptr, target of std::function
+    }
+
+    SECTION("Task with packaged_task moved in")
+    {
+        Task task;
+
+        auto allocations = count_allocations([&] {
+            task = [pt = move(pt)]() mutable { pt(); };
+        });
+
+        REQUIRE(allocations == 0);
+    }
+
+    SECTION("big callables go to the heap")
+    {
+        struct Big
+        {
+            char data[128];
+            void operator()() { }
+        };
+
+        static_assert(!Task::fits_small_buffer<Big>());
+
+        Task task;
+        REQUIRE(count_allocations([&] { task = Big{}; }) == 1);
+    }
+}
+
+TEST_CASE("task wrapping - wrap, queue and run 1000 tasks")
+{
+    const int no_of_tasks = 1000;
+
+    BENCHMARK("std::function + shared_ptr<packaged_task>")
+    {
+        ThreadSafeQueue<function<void()>> q;
+        vector<future<int>> results;
+        results.reserve(no_of_tasks);
+
+        for (int i = 0; i < no_of_tasks; ++i)
+        {
+            auto pt = make_shared<packaged_task<int()>>([i] { return i; });
+            results.push_back(pt->get_future());
+            q.push([pt] { (*pt)(); });
+        }
+
+        function<void()> task;
+        while (q.try_pop(task))
+            task();
+
+        return results.back().get();
+    };
+
+    BENCHMARK("Task + packaged_task")
+    {
+        ThreadSafeQueue<Task> q;
+        vector<future<int>> results;
+        results.reserve(no_of_tasks);
+
+        for (int i = 0; i < no_of_tasks; ++i)
+        {
+            packaged_task<int()> pt{[i] { return i; }};
+            results.push_back(pt.get_future());
+            q.push([pt = move(pt)]() mutable { pt(); });
+        }
+
+        Task task;
+        while (q.try_pop(task))
+            task();
+
+        return results.back().get();
+    };
+}
+
+TEST_CASE("future - allocations per task")
+{
+    SECTION("packaged_task + std::future")
+    {
+        auto allocations = count_allocations([] {
+            packaged_task<int()> pt{[] { return 42; }};
+            auto f = pt.get_future();
+            pt();
+            f.get();
+        });
+
+        REQUIRE(allocations > 0);
+    }
+
+    SECTION("TaskPromise + TaskFuture - shared states are recycled by a thread")
+    {
+        { TaskPromise<int> warm_up; }
+
+        auto allocations = count_allocations([] {
+            TaskPromise<int> promise;
+            auto f = promise.get_future();
+            auto task = [] { return 42; };
+            promise.set_result_of(task);
+            f.get();
+        });
+
+        REQUIRE(allocations == 0);
+    }
+
+    SECTION("ThreadPool::submit")
+    {
+        const int no_of_tasks = 1000;
+
+        ThreadPool<> pool{1};
+        pool.submit([] { return 0; }).get();
+
+        auto allocations = count_allocations([&] {
+            for (int i = 0; i < no_of_tasks; ++i)
+                pool.submit([i] { return i; }).get();
+        });
+
+        // the shared state is released by the worker or by the caller of get() - blocks freed in the worker
+        // are not reused by the submitting thread, deque of the queue allocates a chunk from time to time
+        WARN("allocations per submit: " << static_cast<double>(allocations) / no_of_tasks);
+        REQUIRE(allocations < no_of_tasks * 2);
+    }
+
+    SECTION("WorkStealingThreadPool::submit from a worker - nodes and states are recycled by the worker")
+    {
+        const int no_of_tasks = 1000;
+
+        WorkStealingThreadPool pool{1};
+
+        auto submit_subtasks = [&pool] {
+            for (int i = 0; i < no_of_tasks; ++i)
+            {
+                auto f = pool.submit([i] { return i; });
+                help_until_ready(pool, f);
+            }
+        };
+
+        auto allocations = pool.submit([&] {
+            submit_subtasks(); // warm-up
+            return count_allocations(submit_subtasks);
+        }).get();
+
+        REQUIRE(allocations == 0);
+    }
+}
+
+TEST_CASE("future - set and get 1000 results")
+{
+    const int no_of_tasks = 1000;
+
+    BENCHMARK("packaged_task + std::future")
+    {
+        int sum = 0;
+        for (int i = 0; i < no_of_tasks; ++i)
+        {
+            packaged_task<int()> pt{[i] { return i; }};
+            auto f = pt.get_future();
+            pt();
+            sum += f.get();
+        }
+        return sum;
+    };
+
+    BENCHMARK("TaskPromise + TaskFuture")
+    {
+        int sum = 0;
+        for (int i = 0; i < no_of_tasks; ++i)
+        {
+            TaskPromise<int> promise;
+            auto f = promise.get_future();
+            auto task = [i] { return i; };
+            promise.set_result_of(task);
+            sum += f.get();
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("future - exceptions are propagated")
+{
+    ThreadPool<> pool{2};
+
+    auto f = pool.submit([]() -> int { throw runtime_error{"Error#3"}; });
+    REQUIRE_THROWS_AS(f.get(), runtime_error);
+    REQUIRE_FALSE(f.valid());
+
+    TaskFuture<void> broken;
+    {
+        TaskPromise<void> promise;
+        broken = promise.get_future();
+    }
+    REQUIRE_THROWS_AS(broken.get(), future_error);
+}
+
+TEST_CASE("future - states released by workers do not pile up in their caches")
+{
+    ThreadPool<> pool{1};
+
+    // fire-and-forget - the worker drops the last reference to every state, but never allocates one
+    for (int i = 0; i < 100'000; ++i)
+        pool.submit([] {});
+
+    const size_t cached_states = pool.submit([] { return task_future_details::state_cache()->cached_blocks(); }).get();
+
+    REQUIRE(cached_states <= task_future_details::max_cached_states);
+}
+
+TEST_CASE("continuations")
+{
+    ThreadPool<> pool{2};
+
+    SECTION("then chains results")
+    {
+        auto f = pool.submit([] { return 21; })
+                     .then([](TaskFuture<int> f) { return f.get() * 2; })
+                     .then([](TaskFuture<int> f) { return to_string(f.get()); });
+
+        REQUIRE(f.get() == "42");
+    }
+
+    SECTION("then gets exceptions through the future")
+    {
+        auto f = pool.submit([]() -> int { throw runtime_error{"Error#3"}; }).then([](TaskFuture<int> f) {
+            try
+            {
+                return f.get();
+            }
+            catch (const runtime_error&)
+            {
+                return -1;
+            }
+        });
+
+        REQUIRE(f.get() == -1);
+    }
+
+    SECTION("then on WorkStealingThreadPool")
+    {
+        WorkStealingThreadPool ws_pool{2};
+
+        auto f = ws_pool.submit([] { return 21; }).then([](TaskFuture<int> f) { return f.get() * 2; });
+
+        REQUIRE(f.get() == 42);
+    }
+
+    SECTION("then on a ready future")
+    {
+        auto ready = pool.submit([] { return 1; });
+        ready.wait();
+
+        REQUIRE(ready.then([](TaskFuture<int> f) { return f.get() + 1; }).get() == 2);
+    }
+
+    SECTION("then().get() inside a task")
+    {
+        auto chain_in_task = [](auto& p) {
+            return p.submit([&p] {
+                auto ready = p.submit([] { return 1; });
+                ready.wait();
+
+                return ready.then([](TaskFuture<int> f) { return f.get() + 1; }).get();
+            });
+        };
+
+        REQUIRE(chain_in_task(pool).get() == 2);
+
+        ThreadPool<BoundedThreadSafeQueue<Task>> bounded_pool{2, 1};
+        REQUIRE(chain_in_task(bounded_pool).get() == 2);
+
+        ElasticThreadPool elastic_pool{2, 4};
+        REQUIRE(chain_in_task(elastic_pool).get() == 2);
+    }
+
+    SECTION("when_all")
+    {
+        vector<TaskFuture<int>> fs;
+        for (int i = 0; i < 100; ++i)
+            fs.push_back(pool.submit([i] { return i; }));
+
+        auto fsum = when_all(move(fs)).then([](TaskFuture<vector<TaskFuture<int>>> f) {
+            int sum = 0;
+            for (auto& fi : f.get())
+                sum += fi.get();
+            return sum;
+        });
+
+        REQUIRE(fsum.get() == 4950);
+        REQUIRE(when_all(vector<TaskFuture<int>>{}).get().empty());
+    }
+
+    SECTION("when_any")
+    {
+        TaskPromise<int> never_set;
+        vector<TaskFuture<int>> fs;
+        fs.push_back(never_set.get_future());
+        fs.push_back(pool.submit([] { return 42; }));
+
+        auto result = when_any(move(fs)).get();
+
+        REQUIRE(result.index == 1);
+        REQUIRE(result.futures[1].get() == 42);
+        REQUIRE_FALSE(result.futures[0].is_ready());
+    }
+
+    SECTION("then on futures that lost when_any")
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            TaskPromise<int> first, second;
+            vector<TaskFuture<int>> fs;
+            fs.push_back(first.get_future());
+            fs.push_back(second.get_future());
+
+            auto any = when_any(move(fs));
+
+            thread completing_thd{[&] { second.set_value(2); }};
+            first.set_value(1);
+
+            auto result = any.get();
+            const size_t loser = 1 - result.index;
+
+            // the loser may complete while then() is attached
+            auto f = result.futures[loser].then([](TaskFuture<int> f) { return f.get() * 10; });
+
+            completing_thd.join();
+            REQUIRE(f.get() == static_cast<int>(loser + 1) * 10);
+        }
+    }
+}
+
+TEST_CASE("1000 dependent steps")
+{
+    const int no_of_steps = 1000;
+
+    BENCHMARK("get() in a waiting thread + submit")
+    {
+        ThreadPool<> pool{2};
+
+        int value = 0;
+        for (int i = 0; i < no_of_steps; ++i)
+            value = pool.submit([value] { return value + 1; }).get();
+
+        return value;
+    };
+
+    BENCHMARK("then")
+    {
+        ThreadPool<> pool{2};
+
+        auto f = pool.submit([] { return 0; });
+        for (int i = 1; i < no_of_steps; ++i)
+            f = f.then([](TaskFuture<int> prev) { return prev.get() + 1; });
+
+        return f.get();
+    };
+}
+
+TEMPLATE_TEST_CASE("parallel algorithms", "", ThreadPool<>, WorkStealingThreadPool)
+{
+    TestType pool{3};
+
+    SECTION("parallel_for visits every index once")
+    {
+        vector<int> visits(10'000);
+        parallel_for(pool, IndexRange<size_t>{0, visits.size()}, 100, [&visits](size_t i) { ++visits[i]; });
+
+        REQUIRE(all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+    }
+
+    SECTION("parallel_reduce")
+    {
+        auto sum = parallel_reduce(pool, IndexRange<long long>{1, 100'001}, 0LL,
+            [](const IndexRange<long long>& chunk) {
+                long long partial = 0;
+                for (long long i = chunk.first; i < chunk.last; ++i)
+                    partial += i;
+                return partial;
+            },
+            plus<long long>{});
+
+        REQUIRE(sum == 5'000'050'000LL);
+        REQUIRE(parallel_reduce(pool, IndexRange<int>{5, 5}, 42, [](const auto&) { return 0; }, plus<int>{}) == 42);
+    }
+
+    SECTION("parallel_transform")
+    {
+        vector<int> in(10'000);
+        iota(in.begin(), in.end(), 0);
+        vector<long long> out(in.size());
+
+        auto out_end = parallel_transform(pool, in.begin(), in.end(), out.begin(), [](int x) { return 2LL * x; });
+
+        REQUIRE(out_end == out.end());
+        REQUIRE(out[9'999] == 19'998);
+    }
+
+    SECTION("exceptions are propagated after all chunks are done")
+    {
+        REQUIRE_THROWS_AS(parallel_for(pool, IndexRange<int>{0, 1000}, 10, [](const IndexRange<int>& chunk) {
+            if (chunk.first == 500)
+                throw runtime_error{"chunk failed"};
+        }), runtime_error);
+    }
+}
+
+TEST_CASE("ElasticThreadPool")
+{
+    ElasticThreadPool pool{1, 4, 100ms, 1ms};
+
+    mutex mtx_events;
+    vector<ResizeEvent> events;
+    pool.on_resize([&](const ResizeEvent& e) {
+        lock_guard<mutex> lk{mtx_events};
+        events.push_back(e);
+    });
+
+    auto count_events = [&](ResizeReason reason) {
+        lock_guard<mutex> lk{mtx_events};
+        return count_if(events.begin(), events.end(), [reason](const ResizeEvent& e) { return e.reason == reason; });
+    };
+
+    auto wait_for_size = [&pool](size_t size) {
+        for (int i = 0; i < 100 && pool.size() != size; ++i)
+            this_thread::sleep_for(20ms);
+        return pool.size();
+    };
+
+    SECTION("blocked workers make the pool grow, idle workers retire after keep-alive")
+    {
+        vector<TaskFuture<void>> fs;
+        for (int i = 0; i < 4; ++i)
+            fs.push_back(pool.submit([] {
+                ElasticThreadPool::BlockingScope blocking;
+                this_thread::sleep_for(50ms);
+            }));
+
+        for (auto& f : fs)
+            f.get();
+
+        REQUIRE(count_events(ResizeReason::blocked_workers) + count_events(ResizeReason::queue_delay) > 0);
+        REQUIRE(wait_for_size(1) == 1);
+        REQUIRE(count_events(ResizeReason::idle_timeout) > 0);
+    }
+
+    SECTION("tasks waiting in the queue make the pool grow up to max_threads")
+    {
+        vector<TaskFuture<int>> fs;
+        for (int i = 0; i < 16; ++i)
+            fs.push_back(pool.submit([i] {
+                this_thread::sleep_for(10ms);
+                return i;
+            }));
+
+        int sum = 0;
+        for (auto& f : fs)
+            sum += f.get();
+
+        REQUIRE(sum == 120);
+        REQUIRE(count_events(ResizeReason::queue_delay) > 0);
+
+        lock_guard<mutex> lk{mtx_events};
+        REQUIRE(all_of(events.begin(), events.end(), [](const ResizeEvent& e) { return e.new_size >= 1 && e.new_size <= 4; }));
+    }
+
+    SECTION("pool without min threads starts a worker for a task")
+    {
+        ElasticThreadPool lazy_pool{0, 2, 50ms};
+        REQUIRE(lazy_pool.size() == 0);
+
+        REQUIRE(lazy_pool.submit([] { return 42; }).get() == 42);
+    }
+}
+
+TEST_CASE("CPU topology")
+{
+    SECTION("cpu lists")
+    {
+        REQUIRE(parse_cpu_list("0") == vector<unsigned int>{0});
+        REQUIRE(parse_cpu_list("0-3,8,10-11\n") == vector<unsigned int>{0, 1, 2, 3, 8, 10, 11});
+        REQUIRE(parse_cpu_list("").empty());
+        REQUIRE_THROWS_AS(parse_cpu_list("3-1"), invalid_argument);
+    }
+
+    SECTION("nodes are read from sysfs")
+    {
+        namespace fs = std::filesystem;
+
+        const fs::path cpu_dir = fs::temp_directory_path() / ("fake_sysfs_cpu_" + to_string(hash<thread::id>{}(this_thread::get_id())));
+        fs::remove_all(cpu_dir);
+        fs::create_directories(cpu_dir);
+
+        auto make_cpu = [&cpu_dir](unsigned int cpu, const string& node_entry) {
+            fs::create_directories(cpu_dir / ("cpu" + to_string(cpu)) / node_entry);
+        };
+
+        ofstream{cpu_dir / "online"} << "0-3,6\n";
+        make_cpu(0, "node0");
+        make_cpu(1, "node1");
+        make_cpu(2, "node0");
+        make_cpu(3, "node1");
+        make_cpu(6, "topology");
+        ofstream{cpu_dir / "cpu6" / "topology" / "physical_package_id"} << "3\n"; // no node link - package id is used
+
+        const CpuTopology topology = CpuTopology::from_sysfs(cpu_dir.string());
+        fs::remove_all(cpu_dir);
+
+        REQUIRE(topology.nodes == vector<vector<unsigned int>>{{0, 2}, {1, 3}, {6}});
+        REQUIRE(topology.node_of_cpu(3) == 1);
+        REQUIRE(topology.node_of_cpu(6) == 2);
+        REQUIRE(CpuTopology::from_sysfs((cpu_dir / "missing").string()).nodes.empty());
+    }
+
+    SECTION("detect gives at least one node with a cpu")
+    {
+        const CpuTopology topology = CpuTopology::detect();
+
+        REQUIRE(topology.size() >= 1);
+        REQUIRE(!topology.nodes.front().empty());
+    }
+}
+
+TEST_CASE("NumaThreadPool")
+{
+    SECTION("pinned workers of the detected topology")
+    {
+        NumaThreadPool pool;
+
+        REQUIRE(pool.size() >= pool.node_count());
+        REQUIRE(pool.submit([] { return 42; }).then([](TaskFuture<int> f) { return f.get() + 1; }).get() == 43);
+
+        const CpuTopology& topology = pool.topology();
+        for (size_t node = 0; node < pool.node_count(); ++node)
+        {
+            const int cpu = pool.submit_on(node, [] { return current_cpu(); }).get();
+            REQUIRE(topology.node_of_cpu(static_cast<unsigned int>(cpu)) < pool.node_count());
+        }
+    }
+
+    // two nodes with one unpinned worker each - topology does not have to match the machine
+    NumaThreadPool pool{CpuTopology{{{0}, {0}}}, false, 1};
+    REQUIRE(pool.node_count() == 2);
+    REQUIRE(pool.size() == 2);
+
+    SECTION("submit_on checks the node")
+    {
+        REQUIRE_THROWS_AS(pool.submit_on(2, [] {}), out_of_range);
+    }
+
+    SECTION("idle node steals from a busy one")
+    {
+        TaskPromise<void> release;
+        auto blocked = pool.submit_on(0, [f = release.get_future()]() mutable { f.wait(); return this_thread::get_id(); });
+
+        // the only worker of node 0 is busy - tasks of node 0 are run by the worker of node 1
+        vector<TaskFuture<int>> fs;
+        for (int i = 0; i < 100; ++i)
+            fs.push_back(pool.submit_on(0, [i] { return i; }));
+
+        int sum = 0;
+        for (auto& f : fs)
+            sum += f.get();
+        REQUIRE(sum == 4950);
+
+        release.set_value();
+        REQUIRE(blocked.get() != this_thread::get_id());
+    }
+
+    SECTION("tasks of subtasks are finished before the pool is destroyed")
+    {
+        atomic<int> counter{0};
+        {
+            NumaThreadPool local_pool{CpuTopology{{{0}, {0}}}, false, 2};
+            for (int i = 0; i < 10; ++i)
+                local_pool.submit_on(i % 2, [&local_pool, &counter, i] {
+                    local_pool.submit_on((i + 1) % 2, [&counter] { ++counter; });
+                    ++counter;
+                });
+        }
+
+        REQUIRE(counter == 20);
+    }
+}
+
+TEST_CASE("NumaThreadPool - submit 10k tasks")
+{
+    const int no_of_tasks = 10'000;
+
+    BENCHMARK_ADVANCED("detected topology, pinned")(Catch::Benchmark::Chronometer meter)
+    {
+        NumaThreadPool pool;
+        vector<TaskFuture<int>> results(no_of_tasks);
+
+        meter.measure([&] {
+            for (int i = 0; i < no_of_tasks; ++i)
+                results[i] = pool.submit([i] { return i; });
+
+            for (auto& f : results)
+                f.wait();
+        });
+    };
+}
+
+TEST_CASE("ThreadPool - shutdown")
+{
+    const int no_of_tasks = 10'000;
+
+    atomic<int> no_of_done{0};
+    vector<TaskFuture<void>> results;
+    results.reserve(no_of_tasks);
+
+    // every task takes 1ms - running the whole queue would take seconds
+    auto submit_slow_tasks = [&](ThreadPool<>& pool) {
+        for (int i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([&no_of_done] {
+                this_thread::sleep_for(1ms);
+                ++no_of_done;
+            }));
+    };
+
+    auto count_broken = [&results] {
+        int no_of_broken = 0;
+        for (auto& f : results)
+        {
+            try
+            {
+                f.get();
+            }
+            catch (const future_error& e)
+            {
+                if (e.code() == future_errc::broken_promise)
+                    ++no_of_broken;
+            }
+        }
+        return no_of_broken;
+    };
+
+    SECTION("shutdown_now does not wait for queued tasks - their futures are broken")
+    {
+        ThreadPool<> pool{2};
+        submit_slow_tasks(pool);
+
+        const auto start = chrono::steady_clock::now();
+        pool.shutdown_now();
+        const auto elapsed = chrono::steady_clock::now() - start;
+
+        REQUIRE(elapsed < 1s);
+        REQUIRE(no_of_done < no_of_tasks);
+        REQUIRE(count_broken() == no_of_tasks - no_of_done);
+    }
+
+    SECTION("destructor discards queued tasks")
+    {
+        auto pool = make_unique<ThreadPool<>>(2);
+        submit_slow_tasks(*pool);
+
+        const auto start = chrono::steady_clock::now();
+        pool.reset();
+        const auto elapsed = chrono::steady_clock::now() - start;
+
+        REQUIRE(elapsed < 1s);
+        REQUIRE(count_broken() == no_of_tasks - no_of_done);
+    }
+
+    SECTION("shutdown runs all queued tasks")
+    {
+        ThreadPool<> pool{2};
+        for (int i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([&no_of_done] { ++no_of_done; }));
+
+        pool.shutdown();
+
+        REQUIRE(no_of_done == no_of_tasks);
+        REQUIRE(count_broken() == 0);
+    }
+}
+
+TEST_CASE("ThreadPool - submit 10k tasks")
+{
+    const int no_of_tasks = 10'000;
+
+    for (auto no_of_threads : thread_counts())
+    {
+        BENCHMARK_ADVANCED("threads: " + to_string(no_of_threads))(Catch::Benchmark::Chronometer meter)
+        {
+            ThreadPool<> pool{no_of_threads};
+            vector<TaskFuture<int>> results(no_of_tasks);
+
+            meter.measure([&] {
+                for (int i = 0; i < no_of_tasks; ++i)
+                    results[i] = pool.submit([i] { return i; });
+
+                for (auto& f : results)
+                    f.wait();
+            });
+        };
+    }
+}
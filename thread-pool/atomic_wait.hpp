@@ -0,0 +1,116 @@
+#ifndef ATOMIC_WAIT_HPP
+#define ATOMIC_WAIT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// Blocking on a 32-bit atomic word (C++20 atomic wait/notify for C++17).
+// atomic_wait* block only while the word equals expected, but may also return spuriously - callers re-check the word.
+// On Linux a thread sleeps on a futex, elsewhere on a condition variable from a small table indexed by the word address.
+
+#if defined(__linux__)
+
+namespace atomic_wait_details
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+
+    inline uint32_t* futex_address(std::atomic<uint32_t>& word)
+    {
+        return reinterpret_cast<uint32_t*>(&word);
+    }
+}
+
+inline void atomic_wait(std::atomic<uint32_t>& word, uint32_t expected)
+{
+    ::syscall(SYS_futex, atomic_wait_details::futex_address(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+// returns false when timeout_time has passed
+template <typename Clock, typename Duration>
+bool atomic_wait_until(std::atomic<uint32_t>& word, uint32_t expected, const std::chrono::time_point<Clock, Duration>& timeout_time)
+{
+    const auto timeout = timeout_time - Clock::now();
+    if (timeout <= Duration::zero())
+        return false;
+
+    const auto timeout_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+    timespec relative_timeout{};
+    relative_timeout.tv_sec = static_cast<time_t>(timeout_ns / 1'000'000'000);
+    relative_timeout.tv_nsec = static_cast<long>(timeout_ns % 1'000'000'000);
+
+    ::syscall(SYS_futex, atomic_wait_details::futex_address(word), FUTEX_WAIT_PRIVATE, expected, &relative_timeout, nullptr, 0);
+
+    return true;
+}
+
+inline void atomic_notify_all(std::atomic<uint32_t>& word)
+{
+    ::syscall(SYS_futex, atomic_wait_details::futex_address(word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+namespace atomic_wait_details
+{
+    struct Bucket
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+
+    inline Bucket& bucket_for(const void* address)
+    {
+        static Bucket buckets[64];
+        return buckets[(std::hash<const void*>{}(address) >> 4) % 64];
+    }
+}
+
+inline void atomic_wait(std::atomic<uint32_t>& word, uint32_t expected)
+{
+    auto& bucket = atomic_wait_details::bucket_for(&word);
+
+    std::unique_lock<std::mutex> lk{bucket.mtx};
+    if (word.load() == expected)
+        bucket.cv.wait(lk);
+}
+
+// returns false when timeout_time has passed
+template <typename Clock, typename Duration>
+bool atomic_wait_until(std::atomic<uint32_t>& word, uint32_t expected, const std::chrono::time_point<Clock, Duration>& timeout_time)
+{
+    auto& bucket = atomic_wait_details::bucket_for(&word);
+
+    std::unique_lock<std::mutex> lk{bucket.mtx};
+    if (word.load() == expected)
+        return bucket.cv.wait_until(lk, timeout_time) == std::cv_status::no_timeout;
+
+    return true;
+}
+
+inline void atomic_notify_all(std::atomic<uint32_t>& word)
+{
+    auto& bucket = atomic_wait_details::bucket_for(&word);
+
+    {
+        std::lock_guard<std::mutex> lk{bucket.mtx};
+    }
+    bucket.cv.notify_all();
+}
+
+#endif
+
+#endif // ATOMIC_WAIT_HPP
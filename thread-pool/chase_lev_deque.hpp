@@ -0,0 +1,147 @@
+#ifndef CHASE_LEV_DEQUE_HPP
+#define CHASE_LEV_DEQUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Lock-free work-stealing deque (Chase-Lev, with the C11 memory orderings of Le et al.).
+// The owner thread pushes and pops at the bottom (LIFO), any other thread steals from the top (FIFO).
+// The ring grows when full; old rings are kept until the deque is destroyed, because a thief may still read them.
+template <typename T>
+class ChaseLevDeque
+{
+    static_assert(std::is_trivially_copyable<T>::value, "items are stored in atomics - use pointers or indexes");
+
+    static constexpr size_t cache_line_size = 64;
+
+    class Ring
+    {
+        const int64_t mask_;
+        std::unique_ptr<std::atomic<T>[]> items_;
+
+    public:
+        explicit Ring(int64_t capacity) : mask_{capacity - 1}, items_{new std::atomic<T>[static_cast<size_t>(capacity)]}
+        {
+        }
+
+        int64_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+        void store(int64_t index, T item)
+        {
+            items_[static_cast<size_t>(index & mask_)].store(item, std::memory_order_relaxed);
+        }
+
+        T load(int64_t index) const
+        {
+            return items_[static_cast<size_t>(index & mask_)].load(std::memory_order_relaxed);
+        }
+    };
+
+    alignas(cache_line_size) std::atomic<int64_t> top_{0};
+    alignas(cache_line_size) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_;
+    std::vector<std::unique_ptr<Ring>> rings_; // owner only - current ring is the last one
+
+    Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+    {
+        auto bigger = std::make_unique<Ring>(2 * ring->capacity());
+        for (int64_t i = top; i != bottom; ++i)
+            bigger->store(i, ring->load(i));
+
+        Ring* result = bigger.get();
+        rings_.push_back(std::move(bigger));
+        ring_.store(result, std::memory_order_release);
+
+        return result;
+    }
+
+public:
+    // capacity is rounded up to a power of 2
+    explicit ChaseLevDeque(size_t capacity = 256)
+    {
+        int64_t rounded = 1;
+        while (rounded < static_cast<int64_t>(capacity))
+            rounded <<= 1;
+
+        rings_.push_back(std::make_unique<Ring>(rounded));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    bool empty() const
+    {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+    // owner only
+    void push(T item)
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+
+        if (bottom - top > ring->capacity() - 1)
+            ring = grow(ring, top, bottom);
+
+        ring->store(bottom, item);
+        bottom_.store(bottom + 1, std::memory_order_release); // publishes the item to thieves
+    }
+
+    // owner only - takes the most recently pushed item
+    std::optional<T> pop()
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item{ring->load(bottom)};
+
+        if (top == bottom)
+        {
+            // the last item - race against thieves
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = std::nullopt;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    // any thread - takes the oldest item, returns nullopt when empty or when another thread won the race
+    std::optional<T> steal()
+    {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return std::nullopt;
+
+        const T item = ring_.load(std::memory_order_acquire)->load(top);
+
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return std::nullopt;
+
+        return item;
+    }
+};
+
+#endif // CHASE_LEV_DEQUE_HPP
@@ -0,0 +1,183 @@
+#ifndef CPU_TOPOLOGY_HPP
+#define CPU_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// parses a kernel cpu list, e.g. "0-3,8,10-11"
+inline std::vector<unsigned int> parse_cpu_list(const std::string& text)
+{
+    std::vector<unsigned int> cpus;
+
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos)
+            end = text.size();
+
+        const std::string range = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (range.find_first_not_of(" \t\n") == std::string::npos)
+            continue;
+
+        const size_t dash = range.find('-');
+        const unsigned long first = std::stoul(range.substr(0, dash));
+        const unsigned long last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+
+        if (last < first)
+            throw std::invalid_argument("invalid cpu list: " + text);
+
+        for (unsigned long cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(static_cast<unsigned int>(cpu));
+    }
+
+    return cpus;
+}
+
+// Online CPUs grouped by NUMA node. Node indexes are dense (0, 1, ...) in order of the kernel node ids.
+struct CpuTopology
+{
+    std::vector<std::vector<unsigned int>> nodes; // cpu ids of every node
+
+    size_t size() const
+    {
+        return nodes.size();
+    }
+
+    // node index of a cpu - 0 for an unknown cpu
+    size_t node_of_cpu(unsigned int cpu) const
+    {
+        for (size_t node = 0; node < nodes.size(); ++node)
+        {
+            if (std::find(nodes[node].begin(), nodes[node].end(), cpu) != nodes[node].end())
+                return node;
+        }
+
+        return 0;
+    }
+
+    // one node with cpus 0..no_of_cpus-1 - used when the topology cannot be read
+    static CpuTopology uniform(unsigned int no_of_cpus = std::max(std::thread::hardware_concurrency(), 1u))
+    {
+        CpuTopology topology;
+        topology.nodes.emplace_back();
+        for (unsigned int cpu = 0; cpu < no_of_cpus; ++cpu)
+            topology.nodes.back().push_back(cpu);
+
+        return topology;
+    }
+
+    // reads <cpu_dir>/online and the node of every online cpu - the nodeN link in <cpu_dir>/cpuN,
+    // or the physical package when the kernel has no NUMA support
+    static CpuTopology from_sysfs(const std::string& cpu_dir)
+    {
+        namespace fs = std::filesystem;
+
+        std::ifstream online_file{cpu_dir + "/online"};
+        std::string online;
+        if (!online_file || !std::getline(online_file, online))
+            return CpuTopology{};
+
+        std::map<unsigned int, std::vector<unsigned int>> cpus_by_node_id;
+        for (unsigned int cpu : parse_cpu_list(online))
+            cpus_by_node_id[node_id_of(fs::path{cpu_dir} / ("cpu" + std::to_string(cpu)))].push_back(cpu);
+
+        CpuTopology topology;
+        for (auto& node : cpus_by_node_id)
+            topology.nodes.push_back(std::move(node.second));
+
+        return topology;
+    }
+
+    // topology of the cpus the process may run on (its affinity mask) - uniform() when sysfs cannot be read
+    static CpuTopology detect(const std::string& cpu_dir = "/sys/devices/system/cpu")
+    {
+        CpuTopology topology = from_sysfs(cpu_dir);
+
+        for (auto& cpus : topology.nodes)
+            cpus.erase(std::remove_if(cpus.begin(), cpus.end(), [](unsigned int cpu) { return !is_allowed(cpu); }), cpus.end());
+
+        topology.nodes.erase(std::remove_if(topology.nodes.begin(), topology.nodes.end(), [](const auto& cpus) { return cpus.empty(); }),
+            topology.nodes.end());
+
+        return topology.nodes.empty() ? uniform() : topology;
+    }
+
+private:
+    static unsigned int node_id_of(const std::filesystem::path& cpu_path)
+    {
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        for (fs::directory_iterator it{cpu_path, ec}, end; !ec && it != end; it.increment(ec))
+        {
+            const std::string name = it->path().filename().string();
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0
+                && std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); }))
+                return static_cast<unsigned int>(std::stoul(name.substr(4)));
+        }
+
+        std::ifstream package_file{cpu_path / "topology" / "physical_package_id"};
+        int package_id = 0;
+        if (package_file >> package_id && package_id >= 0)
+            return static_cast<unsigned int>(package_id);
+
+        return 0;
+    }
+
+    static bool is_allowed(unsigned int cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t mask;
+        if (::sched_getaffinity(0, sizeof(mask), &mask) == 0 && cpu < CPU_SETSIZE)
+            return CPU_ISSET(cpu, &mask);
+#endif
+        (void)cpu;
+        return true;
+    }
+};
+
+// pins the calling thread to one cpu - returns false when it is not supported or not allowed
+inline bool pin_current_thread(unsigned int cpu)
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// cpu the calling thread runs on - -1 when unknown
+inline int current_cpu()
+{
+#if defined(__linux__)
+    return ::sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+#endif // CPU_TOPOLOGY_HPP
@@ -0,0 +1,351 @@
+#ifndef ELASTIC_THREAD_POOL_HPP
+#define ELASTIC_THREAD_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "executor.hpp"
+#include "task_future.hpp"
+#include "thread_safe_queue.hpp"
+
+enum class ResizeReason
+{
+    queue_delay,     // a task waited in the queue longer than max_queue_delay
+    blocked_workers, // a worker entered a BlockingScope while no worker was idle
+    idle_timeout     // a worker got no task for keep_alive and retired
+};
+
+struct ResizeEvent
+{
+    size_t old_size;
+    size_t new_size;
+    ResizeReason reason;
+};
+
+// Thread pool that keeps between min_threads and max_threads workers:
+//  - it grows when a task waits in the queue longer than max_queue_delay (checked when a task is submitted
+//    and when a worker takes a task) or when a busy worker announces a blocking call with BlockingScope,
+//  - a worker that gets no task for keep_alive retires (down to min_threads).
+class ElasticThreadPool : public Executor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using ResizeHandler = std::function<void(const ResizeEvent&)>;
+
+    // marks the current worker as blocked (sleeping, waiting for I/O) for its lifetime - when no other worker is idle
+    // the pool starts another one; does nothing outside of an ElasticThreadPool worker
+    class BlockingScope
+    {
+        ElasticThreadPool* pool_;
+
+    public:
+        BlockingScope() : pool_{this_worker().pool}
+        {
+            if (pool_)
+                pool_->enter_blocking();
+        }
+
+        BlockingScope(const BlockingScope&) = delete;
+        BlockingScope& operator=(const BlockingScope&) = delete;
+
+        ~BlockingScope()
+        {
+            if (pool_)
+                pool_->blocked_workers_.fetch_sub(1);
+        }
+    };
+
+private:
+    struct TimedTask
+    {
+        Task task;
+        Clock::time_point enqueued_at;
+    };
+
+    using Workers = std::list<std::thread>;
+
+    struct WorkerContext
+    {
+        ElasticThreadPool* pool;
+    };
+
+    const size_t min_threads_;
+    const size_t max_threads_;
+    const Clock::duration keep_alive_;
+    const Clock::duration max_queue_delay_;
+
+    ThreadSafeQueue<TimedTask> q_tasks_;
+
+    std::mutex mtx_workers_;
+    Workers workers_;
+    std::vector<std::thread> retired_; // joined by the next grow or the destructor
+    bool is_stopping_{false};
+    ResizeHandler resize_handler_;
+
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> idle_workers_{0};
+    std::atomic<size_t> blocked_workers_{0};
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<Clock::rep> last_dequeue_{Clock::now().time_since_epoch().count()};
+
+    static WorkerContext& this_worker()
+    {
+        thread_local WorkerContext context{nullptr};
+        return context;
+    }
+
+    // must be called with mtx_workers_ locked
+    void start_worker()
+    {
+        workers_.emplace_back();
+        const auto self = std::prev(workers_.end());
+
+        try
+        {
+            *self = std::thread{[this, self] { run(self); }};
+        }
+        catch (...)
+        {
+            workers_.erase(self);
+            throw;
+        }
+
+        size_.store(workers_.size());
+    }
+
+    void notify_resize(const ResizeEvent& event)
+    {
+        ResizeHandler handler;
+        {
+            std::lock_guard<std::mutex> lk{mtx_workers_};
+            handler = resize_handler_;
+        }
+
+        if (handler)
+            handler(event);
+    }
+
+    void grow(ResizeReason reason)
+    {
+        ResizeEvent event{0, 0, reason};
+        std::vector<std::thread> retired;
+        {
+            std::lock_guard<std::mutex> lk{mtx_workers_};
+
+            if (is_stopping_ || workers_.size() >= max_threads_)
+                return;
+
+            retired.swap(retired_);
+
+            event.old_size = workers_.size();
+            start_worker();
+            event.new_size = workers_.size();
+        }
+
+        for (auto& thd : retired)
+            thd.join();
+
+        notify_resize(event);
+    }
+
+    bool try_retire(Workers::iterator self)
+    {
+        ResizeEvent event{0, 0, ResizeReason::idle_timeout};
+        {
+            std::lock_guard<std::mutex> lk{mtx_workers_};
+
+            if (is_stopping_ || workers_.size() <= min_threads_)
+                return false;
+
+            // pairs with submit: it counts a task first and checks the size later, here it is the other way round,
+            // so either the task is seen here or submit sees the smaller pool and grows it
+            size_.store(workers_.size() - 1);
+            if (pending_tasks_.load() > 0)
+            {
+                size_.store(workers_.size());
+                return false;
+            }
+
+            event.old_size = workers_.size();
+            retired_.push_back(std::move(*self));
+            workers_.erase(self);
+            event.new_size = workers_.size();
+        }
+
+        notify_resize(event);
+
+        return true;
+    }
+
+    bool is_queue_stalled() const
+    {
+        const Clock::time_point last_dequeue{Clock::duration{last_dequeue_.load()}};
+        return pending_tasks_.load() > 0 && Clock::now() - last_dequeue > max_queue_delay_;
+    }
+
+    // when it throws (closed queue) the task is left in place
+    void enqueue(Task& task)
+    {
+        TimedTask timed_task{std::move(task), Clock::now()};
+
+        pending_tasks_.fetch_add(1);
+        try
+        {
+            q_tasks_.push(std::move(timed_task)); // push does not consume the item when it throws
+        }
+        catch (...)
+        {
+            pending_tasks_.fetch_sub(1);
+            task = std::move(timed_task.task);
+            throw;
+        }
+
+        if (size_.load() == 0 || (idle_workers_.load() == 0 && is_queue_stalled()))
+            grow(ResizeReason::queue_delay);
+    }
+
+    void enter_blocking()
+    {
+        blocked_workers_.fetch_add(1);
+
+        if (idle_workers_.load() == 0)
+            grow(ResizeReason::blocked_workers);
+    }
+
+    void run_task(TimedTask& timed_task)
+    {
+        const auto now = Clock::now();
+        pending_tasks_.fetch_sub(1);
+        last_dequeue_.store(now.time_since_epoch().count());
+
+        if (now - timed_task.enqueued_at > max_queue_delay_ && pending_tasks_.load() > 0)
+            grow(ResizeReason::queue_delay);
+
+        timed_task.task();
+    }
+
+    void run(Workers::iterator self)
+    {
+        this_worker() = WorkerContext{this};
+
+        TimedTask timed_task;
+        while (true)
+        {
+            idle_workers_.fetch_add(1);
+            const QueueStatus status = q_tasks_.pop_for(timed_task, keep_alive_);
+            idle_workers_.fetch_sub(1);
+
+            if (status == QueueStatus::success)
+            {
+                run_task(timed_task);
+                timed_task.task = nullptr;
+            }
+            else if (status == QueueStatus::closed || try_retire(self))
+                return;
+        }
+    }
+
+public:
+    ElasticThreadPool(size_t min_threads, size_t max_threads, std::chrono::milliseconds keep_alive = std::chrono::seconds{60},
+        std::chrono::milliseconds max_queue_delay = std::chrono::milliseconds{10})
+        : min_threads_{min_threads}, max_threads_{max_threads}, keep_alive_{keep_alive}, max_queue_delay_{max_queue_delay}
+    {
+        if (max_threads_ == 0 || min_threads_ > max_threads_)
+            throw std::invalid_argument("expected 0 <= min_threads <= max_threads and max_threads > 0");
+
+        std::lock_guard<std::mutex> lk{mtx_workers_};
+        for (size_t i = 0; i < min_threads_; ++i)
+            start_worker();
+    }
+
+    ElasticThreadPool(const ElasticThreadPool&) = delete;
+    ElasticThreadPool& operator=(const ElasticThreadPool&) = delete;
+
+    ~ElasticThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_workers_};
+            is_stopping_ = true;
+        }
+
+        // workers finish all queued tasks and exit
+        q_tasks_.close();
+
+        for (auto& thd : workers_)
+            thd.join();
+        for (auto& thd : retired_)
+            thd.join();
+    }
+
+    // current number of workers
+    size_t size() const
+    {
+        return size_.load();
+    }
+
+    // number of workers inside a BlockingScope
+    size_t blocked_size() const
+    {
+        return blocked_workers_.load();
+    }
+
+    // handler is called after every resize by the thread that caused it - it must not block
+    void on_resize(ResizeHandler handler)
+    {
+        std::lock_guard<std::mutex> lk{mtx_workers_};
+        resize_handler_ = std::move(handler);
+    }
+
+    template <typename Callable>
+    auto submit(Callable&& task)
+    {
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        TaskPromise<ResultT> promise{this};
+        TaskFuture<ResultT> fresult = promise.get_future();
+
+        Task wrapped_task{[task = std::forward<Callable>(task), promise = std::move(promise)]() mutable {
+            promise.set_result_of(task);
+        }};
+        enqueue(wrapped_task);
+
+        return fresult;
+    }
+
+    // used for continuations of futures - they go to the queue, so any worker (or a thread waiting
+    // in run_pending_task) can run them; during shutdown (closed queue) the task runs in the calling thread
+    void execute(Task task) override
+    {
+        try
+        {
+            enqueue(task);
+        }
+        catch (const QueueClosed&)
+        {
+            task();
+        }
+    }
+
+    // runs one queued task in the calling thread - lets a task wait for its subtasks without blocking a worker
+    bool run_pending_task()
+    {
+        TimedTask timed_task;
+        if (!q_tasks_.try_pop(timed_task))
+            return false;
+
+        run_task(timed_task);
+        return true;
+    }
+};
+
+#endif // ELASTIC_THREAD_POOL_HPP
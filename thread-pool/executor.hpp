@@ -0,0 +1,19 @@
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+#include "unique_function.hpp"
+
+using Task = UniqueFunction<void()>;
+
+// Something that runs tasks - thread pools implement it so futures can schedule continuations on them.
+// execute must run every task it accepts (e.g. in the calling thread when the pool is shutting down).
+class Executor
+{
+public:
+    virtual void execute(Task task) = 0;
+
+protected:
+    ~Executor() = default;
+};
+
+#endif // EXECUTOR_HPP
@@ -9,13 +9,18 @@
 #include <future>
 #include <random>
 #include "thread_safe_queue.hpp"
+#include "bounded_thread_safe_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "priority_thread_safe_queue.hpp"
+#include "thread_pool.hpp"
+#include "elastic_thread_pool.hpp"
 
 using namespace std::literals;
 
-using Task = std::function<void()>;
-
 namespace ver_1_0
 {
+    using Task = std::function<void()>;
+
     static Task end_of_work;
 
     class ThreadPool
@@ -66,60 +71,6 @@ namespace ver_1_0
     };
 }
 
-namespace ver_1_1
-{
-    class ThreadPool
-    {
-        std::vector<std::thread> threads_;
-        ThreadSafeQueue<Task> q_tasks_;
-        std::atomic<bool> is_done_{false};
-
-        void run()
-        {
-            while(true)
-            {
-                Task task;
-                q_tasks_.pop(task);
-
-                task();
-
-                if (is_done_)
-                    return;
-            }
-        }
-
-    public:
-        ThreadPool(size_t size) : threads_(size)
-        {
-            for(size_t i = 0; i < size; ++i)
-                threads_[i] = std::thread{ [this] { run(); } };
-        }
-
-        template <typename Callable>
-        auto submit(Callable&& task) //-> decltype(task())
-        {
-            using ResultT = decltype(task());
-
-            auto pt = std::make_shared<std::packaged_task<ResultT()>>(task);
-            std::future<ResultT> fresult = pt->get_future();
-
-            q_tasks_.push([pt] {(*pt)(); });
-
-            return fresult;
-        }
-
-        ~ThreadPool()
-        {
-            for(size_t i = 0; i < threads_.size(); ++i)
-                submit([this] { is_done_ = true; });
-
-            for(auto& thd : threads_)
-                if (thd.joinable())
-                    thd.join();
-        }
-    };
-}
-
 void background_work(size_t id, const std::string& text, std::chrono::milliseconds delay)
 {
     std::cout << "bw#" << id << " has started in a thread#" << std::this_thread::get_id() << std::endl;
@@ -141,7 +92,10 @@ int calculate_square(int x)
     std::random_device rd;
     std::uniform_int_distribution<> distr(100, 5000);
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(distr(rd)));
+    {
+        ElasticThreadPool::BlockingScope blocking; // lets an elastic pool start another worker meanwhile
+        std::this_thread::sleep_for(std::chrono::milliseconds(distr(rd)));
+    }
 
     if (x % 3 == 0)
         throw std::runtime_error("Error#3");
@@ -151,31 +105,42 @@ int calculate_square(int x)
 
 int main()
 {
-    using namespace ver_1_1;
-
     std::cout << "Main thread starts..." << std::endl;
     const std::string text = "Hello Threads";
 
-    ThreadPool thread_pool(4);
+    ElasticThreadPool thread_pool(2, 8, 1s);
+    thread_pool.on_resize([](const ResizeEvent& e) {
+        std::cout << "pool resized: " << e.old_size << " -> " << e.new_size << std::endl;
+    });
 
-    std::vector<std::future<int>> fresults;
+    std::vector<TaskFuture<int>> fsquares;
 
+    // results are printed by continuations as soon as they are ready - in any order
     for(int i = 1; i < 20; ++i)
-        fresults.push_back(thread_pool.submit([i] { return calculate_square(i); }));
-
-
-    for(auto& f : fresults)
     {
-        try
-        {
-            int r = f.get();
-            std::cout << "result: " << r << std::endl;
-        }
-        catch(const std::exception& e)
-        {
-            std::cout << e.what() << std::endl;
-        }
+        fsquares.push_back(thread_pool.submit([i] { return calculate_square(i); }).then([](TaskFuture<int> f) {
+            try
+            {
+                int r = f.get();
+                std::cout << "result: " << r << std::endl;
+                return r;
+            }
+            catch(const std::exception& e)
+            {
+                std::cout << e.what() << std::endl;
+                return 0;
+            }
+        }));
     }
 
+    auto fsum = when_all(std::move(fsquares)).then([](TaskFuture<std::vector<TaskFuture<int>>> f) {
+        int sum = 0;
+        for(auto& fsquare : f.get())
+            sum += fsquare.get();
+        return sum;
+    });
+
+    std::cout << "sum of squares: " << fsum.get() << std::endl;
+
     std::cout << "Main thread ends..." << std::endl;
 }
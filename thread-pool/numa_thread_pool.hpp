@@ -0,0 +1,283 @@
+#ifndef NUMA_THREAD_POOL_HPP
+#define NUMA_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "cpu_topology.hpp"
+#include "executor.hpp"
+#include "task_future.hpp"
+#include "thread_safe_queue.hpp"
+
+// Thread pool with one group of workers per NUMA node. Every group has its own task queue:
+//  - submit puts a task into the queue of the node the caller runs on (a worker - its own node),
+//    submit_on(node, task) into the queue of the given node,
+//  - a worker takes tasks from its node queue and steals from other nodes only when its own queue is empty,
+//  - with pin_workers every worker is pinned to one cpu of its node, so the memory it touches first
+//    is allocated on that node.
+class NumaThreadPool : public Executor
+{
+    struct Node
+    {
+        ThreadSafeQueue<Task> tasks;
+
+        // idle workers of the node park until new work is signalled - a wake-up claims one sleeping worker
+        // right away (sleeping_workers counts only unclaimed ones), so the next submit sees that the node
+        // has no idle worker left and wakes a worker of another node instead
+        std::atomic<uint64_t> work_epoch{0};
+        std::atomic<int> sleeping_workers{0};
+        int claimed_wakeups{0}; // guarded by mtx_idle
+        std::mutex mtx_idle;
+        std::condition_variable cv_work;
+    };
+
+    struct WorkerContext
+    {
+        NumaThreadPool* pool;
+        size_t node;
+    };
+
+    CpuTopology topology_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> is_stopping_{false};
+
+    static WorkerContext& this_worker()
+    {
+        thread_local WorkerContext context{nullptr, 0};
+        return context;
+    }
+
+    size_t caller_node() const
+    {
+        const WorkerContext& context = this_worker();
+        if (context.pool == this)
+            return context.node;
+
+        const int cpu = current_cpu();
+        return cpu < 0 ? 0 : topology_.node_of_cpu(static_cast<unsigned int>(cpu));
+    }
+
+    static bool wake_one(Node& node)
+    {
+        node.work_epoch.fetch_add(1, std::memory_order_seq_cst);
+
+        if (node.sleeping_workers.load(std::memory_order_seq_cst) == 0)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lk{node.mtx_idle};
+
+            if (node.sleeping_workers.load(std::memory_order_relaxed) == 0)
+                return false;
+
+            node.sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+            ++node.claimed_wakeups;
+        }
+        node.cv_work.notify_one();
+
+        return true;
+    }
+
+    // wakes a worker of the node - when all of them are busy, an idle worker of another node that can steal the task
+    void signal_work(size_t node)
+    {
+        if (wake_one(*nodes_[node]))
+            return;
+
+        for (size_t i = 1; i < nodes_.size(); ++i)
+        {
+            if (wake_one(*nodes_[(node + i) % nodes_.size()]))
+                return;
+        }
+    }
+
+    void wait_for_work(Node& node, uint64_t seen_epoch)
+    {
+        std::unique_lock<std::mutex> lk{node.mtx_idle};
+
+        node.sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+        node.cv_work.wait(lk, [&] {
+            return node.claimed_wakeups > 0 || node.work_epoch.load(std::memory_order_seq_cst) != seen_epoch
+                || is_stopping_.load();
+        });
+
+        // any waker's claim may be consumed - either way one sleeper less is counted
+        if (node.claimed_wakeups > 0)
+            --node.claimed_wakeups;
+        else
+            node.sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // own node first, other nodes (nearest index first) only when it has nothing to do
+    bool find_task(size_t node, Task& task)
+    {
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            if (nodes_[(node + i) % nodes_.size()]->tasks.try_pop(task))
+                return true;
+        }
+
+        return false;
+    }
+
+    void worker_loop(size_t node, int cpu)
+    {
+        this_worker() = WorkerContext{this, node};
+
+        if (cpu >= 0)
+            pin_current_thread(static_cast<unsigned int>(cpu));
+
+        Node& local_node = *nodes_[node];
+        Task task;
+
+        while (true)
+        {
+            const uint64_t epoch = local_node.work_epoch.load(std::memory_order_seq_cst);
+
+            if (find_task(node, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            if (is_stopping_.load())
+                return;
+
+            wait_for_work(local_node, epoch);
+        }
+    }
+
+    void push_task(size_t node, Task task)
+    {
+        nodes_[node]->tasks.push(std::move(task));
+        signal_work(node);
+    }
+
+public:
+    // workers_per_node == 0 starts one worker per cpu of every node
+    explicit NumaThreadPool(CpuTopology topology = CpuTopology::detect(), bool pin_workers = true, size_t workers_per_node = 0)
+        : topology_{std::move(topology)}
+    {
+        if (topology_.nodes.empty())
+            throw std::invalid_argument("topology without nodes");
+
+        for (size_t node = 0; node < topology_.nodes.size(); ++node)
+            nodes_.push_back(std::make_unique<Node>());
+
+        try
+        {
+            for (size_t node = 0; node < topology_.nodes.size(); ++node)
+            {
+                const auto& cpus = topology_.nodes[node];
+                const size_t no_of_workers = workers_per_node > 0 ? workers_per_node : std::max<size_t>(cpus.size(), 1);
+
+                for (size_t i = 0; i < no_of_workers; ++i)
+                {
+                    const int cpu = pin_workers && !cpus.empty() ? static_cast<int>(cpus[i % cpus.size()]) : -1;
+                    threads_.emplace_back([this, node, cpu] { worker_loop(node, cpu); });
+                }
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    NumaThreadPool(const NumaThreadPool&) = delete;
+    NumaThreadPool& operator=(const NumaThreadPool&) = delete;
+
+    // workers finish all submitted tasks (including tasks submitted by tasks) before they exit
+    ~NumaThreadPool()
+    {
+        stop();
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    size_t node_count() const
+    {
+        return nodes_.size();
+    }
+
+    const CpuTopology& topology() const
+    {
+        return topology_;
+    }
+
+    template <typename Callable>
+    auto submit(Callable&& task)
+    {
+        return submit_on(caller_node(), std::forward<Callable>(task));
+    }
+
+    // node is a hint where the task should run - an idle worker of another node may still steal it
+    template <typename Callable>
+    auto submit_on(size_t node, Callable&& task)
+    {
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        if (node >= nodes_.size())
+            throw std::out_of_range("no NUMA node " + std::to_string(node) + " in the pool");
+
+        TaskPromise<ResultT> promise{this};
+        TaskFuture<ResultT> fresult = promise.get_future();
+
+        push_task(node, Task{[task = std::forward<Callable>(task), promise = std::move(promise)]() mutable {
+            promise.set_result_of(task);
+        }});
+
+        return fresult;
+    }
+
+    // used for continuations of futures - they stay on the node of the thread that scheduled them
+    void execute(Task task) override
+    {
+        push_task(caller_node(), std::move(task));
+    }
+
+    // runs one pending task (preferably of the caller's node) in the calling thread
+    bool run_pending_task()
+    {
+        Task task;
+        if (!find_task(caller_node(), task))
+            return false;
+
+        task();
+        return true;
+    }
+
+private:
+    void stop()
+    {
+        is_stopping_.store(true);
+
+        for (auto& node : nodes_)
+        {
+            {
+                std::lock_guard<std::mutex> lk{node->mtx_idle};
+            }
+            node->cv_work.notify_all();
+        }
+
+        for (auto& thd : threads_)
+            thd.join();
+    }
+};
+
+#endif // NUMA_THREAD_POOL_HPP
@@ -0,0 +1,168 @@
+#ifndef PARALLEL_ALGORITHMS_HPP
+#define PARALLEL_ALGORITHMS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Fork/join algorithms on a thread pool (ThreadPool or WorkStealingThreadPool).
+// A range is split in halves until it is not bigger than grain - the left half is submitted to the pool,
+// the right one is processed by the current thread, which then runs other pending tasks until the left half is done.
+// The calling thread takes part in the work, so a job reuses pool threads instead of spawning new ones.
+// grain == 0 picks a grain that gives about 8 chunks per thread.
+// Workers submit subtasks themselves - use a pool with an unbounded queue.
+
+template <typename Index>
+struct IndexRange
+{
+    Index first;
+    Index last;
+
+    IndexRange(Index first, Index last) : first{first}, last{last}
+    {
+    }
+
+    Index size() const
+    {
+        return last - first;
+    }
+
+    bool empty() const
+    {
+        return !(first < last);
+    }
+};
+
+namespace parallel_details
+{
+    template <typename Pool, typename Future>
+    void help_until_ready(Pool& pool, Future& f)
+    {
+        while (!f.is_ready())
+        {
+            if (!pool.run_pending_task())
+                std::this_thread::yield();
+        }
+    }
+
+    template <typename Pool, typename Index>
+    Index auto_grain(Pool& pool, const IndexRange<Index>& range, Index grain)
+    {
+        if (grain > 0)
+            return grain;
+
+        const Index chunks = static_cast<Index>(8 * (pool.size() + 1));
+        return std::max(static_cast<Index>(range.size() / chunks), Index{1});
+    }
+
+    template <typename Pool, typename Index, typename Result, typename Map, typename Combine>
+    Result reduce(Pool& pool, IndexRange<Index> range, Index grain, Map& map, Combine& combine)
+    {
+        if (range.size() <= grain)
+            return map(range);
+
+        const Index middle = range.first + range.size() / 2;
+
+        auto left = pool.submit([&pool, &map, &combine, first = range.first, middle, grain] {
+            return reduce<Pool, Index, Result>(pool, IndexRange<Index>{first, middle}, grain, map, combine);
+        });
+
+        Result right_result = [&] {
+            try
+            {
+                return reduce<Pool, Index, Result>(pool, IndexRange<Index>{middle, range.last}, grain, map, combine);
+            }
+            catch (...)
+            {
+                help_until_ready(pool, left); // the left half still uses map and combine
+                throw;
+            }
+        }();
+
+        help_until_ready(pool, left);
+
+        return combine(left.get(), std::move(right_result));
+    }
+
+    template <typename Pool, typename Index, typename Body>
+    void for_each_chunk(Pool& pool, IndexRange<Index> range, Index grain, Body& body)
+    {
+        if (range.size() <= grain)
+        {
+            body(range);
+            return;
+        }
+
+        const Index middle = range.first + range.size() / 2;
+
+        auto left = pool.submit([&pool, &body, first = range.first, middle, grain] {
+            for_each_chunk(pool, IndexRange<Index>{first, middle}, grain, body);
+        });
+
+        try
+        {
+            for_each_chunk(pool, IndexRange<Index>{middle, range.last}, grain, body);
+        }
+        catch (...)
+        {
+            help_until_ready(pool, left);
+            throw;
+        }
+
+        help_until_ready(pool, left);
+        left.get();
+    }
+}
+
+// f is called either with a chunk (IndexRange<Index>) or with every index of the range
+template <typename Pool, typename Index, typename F>
+void parallel_for(Pool& pool, IndexRange<Index> range, typename std::common_type<Index>::type grain, F f)
+{
+    if (range.empty())
+        return;
+
+    auto body = [&f](const IndexRange<Index>& chunk) {
+        if constexpr (std::is_invocable<F&, const IndexRange<Index>&>::value)
+            f(chunk);
+        else
+        {
+            for (Index i = chunk.first; i < chunk.last; ++i)
+                f(i);
+        }
+    };
+
+    parallel_details::for_each_chunk(pool, range, parallel_details::auto_grain(pool, range, grain), body);
+}
+
+// map(IndexRange<Index>) gives a partial result of a chunk, combine(Result, Result) merges two partial results
+// (it has to be associative). Returns identity for an empty range.
+template <typename Pool, typename Index, typename Result, typename Map, typename Combine>
+Result parallel_reduce(Pool& pool, IndexRange<Index> range, Result identity, Map map, Combine combine)
+{
+    if (range.empty())
+        return identity;
+
+    return combine(std::move(identity),
+        parallel_details::reduce<Pool, Index, Result>(pool, range, parallel_details::auto_grain(pool, range, Index{0}), map, combine));
+}
+
+// writes f(*it) for every element of [first, last) to d_first - both sequences need random access iterators
+template <typename Pool, typename InputIt, typename OutputIt, typename F>
+OutputIt parallel_transform(Pool& pool, InputIt first, InputIt last, OutputIt d_first, F f, size_t grain = 0)
+{
+    using Index = typename std::iterator_traits<InputIt>::difference_type;
+
+    const Index size = std::distance(first, last);
+
+    parallel_for(pool, IndexRange<Index>{0, size}, static_cast<Index>(grain), [&](const IndexRange<Index>& chunk) {
+        std::transform(first + chunk.first, first + chunk.last, d_first + chunk.first, f);
+    });
+
+    return d_first + size;
+}
+
+#endif // PARALLEL_ALGORITHMS_HPP
@@ -0,0 +1,176 @@
+#ifndef RECYCLING_ALLOCATOR_HPP
+#define RECYCLING_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Keeps freed blocks on per-size free lists and hands them out again, so a container
+// that repeatedly allocates blocks of the same size (e.g. std::deque) stops hitting the heap
+// once it reaches its steady-state footprint.
+// At most max_cached_blocks blocks are kept per size - the rest go back to the heap, so a cache that only
+// receives blocks (e.g. freed by another thread than the one that allocated them) does not grow without bound.
+// Not synchronized - it is meant for containers guarded by an external lock (e.g. ThreadSafeQueue).
+class BlockCache
+{
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct FreeList
+    {
+        size_t block_size;
+        FreeBlock* head;
+        size_t count;
+    };
+
+    const size_t max_cached_blocks_;
+    std::vector<FreeList> free_lists_;
+
+    static size_t block_size(size_t bytes)
+    {
+        return std::max(bytes, sizeof(FreeBlock));
+    }
+
+    FreeList* find_free_list(size_t size)
+    {
+        auto it = std::find_if(free_lists_.begin(), free_lists_.end(), [size](const FreeList& fl) { return fl.block_size == size; });
+        return it != free_lists_.end() ? &*it : nullptr;
+    }
+
+public:
+    static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+    explicit BlockCache(size_t max_cached_blocks = unlimited) : max_cached_blocks_{max_cached_blocks}
+    {
+    }
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    ~BlockCache()
+    {
+        for (auto& fl : free_lists_)
+        {
+            while (fl.head)
+            {
+                FreeBlock* block = fl.head;
+                fl.head = block->next;
+                ::operator delete(block);
+            }
+        }
+    }
+
+    void* allocate(size_t bytes)
+    {
+        const size_t size = block_size(bytes);
+
+        FreeList* fl = find_free_list(size);
+        if (fl && fl->head)
+        {
+            FreeBlock* block = fl->head;
+            fl->head = block->next;
+            --fl->count;
+            return block;
+        }
+
+        return ::operator new(size);
+    }
+
+    void deallocate(void* ptr, size_t bytes) noexcept
+    {
+        const size_t size = block_size(bytes);
+
+        FreeList* fl = find_free_list(size);
+        if (!fl)
+        {
+            if (max_cached_blocks_ == 0)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            try
+            {
+                free_lists_.push_back(FreeList{size, nullptr, 0});
+            }
+            catch (const std::bad_alloc&)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            fl = &free_lists_.back();
+        }
+        else if (fl->count >= max_cached_blocks_)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        fl->head = new (ptr) FreeBlock{fl->head};
+        ++fl->count;
+    }
+
+    // number of blocks kept for reuse (all sizes)
+    size_t cached_blocks() const
+    {
+        size_t count = 0;
+        for (const auto& fl : free_lists_)
+            count += fl.count;
+
+        return count;
+    }
+};
+
+// std-compatible allocator - all copies and rebinds share one BlockCache
+template <typename T>
+class RecyclingAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+    std::shared_ptr<BlockCache> cache_;
+
+    template <typename U>
+    friend class RecyclingAllocator;
+
+public:
+    using value_type = T;
+
+    RecyclingAllocator() : cache_{std::make_shared<BlockCache>()}
+    {
+    }
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U>& other) noexcept : cache_{other.cache_}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(cache_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        cache_->deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const RecyclingAllocator<U>& other) const noexcept
+    {
+        return cache_ == other.cache_;
+    }
+
+    template <typename U>
+    bool operator!=(const RecyclingAllocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+#endif // RECYCLING_ALLOCATOR_HPP
@@ -0,0 +1,629 @@
+#ifndef TASK_FUTURE_HPP
+#define TASK_FUTURE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "atomic_wait.hpp"
+#include "executor.hpp"
+#include "recycling_allocator.hpp"
+
+template <typename T>
+class TaskFuture;
+
+template <typename T>
+class TaskPromise;
+
+namespace task_future_details
+{
+    // set when the thread-local cache is gone (thread exit) - states released later go straight to the heap
+    inline thread_local bool is_state_cache_destroyed = false;
+
+    // a thread that only releases states (a worker running fire-and-forget tasks) never reuses them -
+    // beyond this limit they go back to the heap
+    constexpr size_t max_cached_states = 256;
+
+    struct StateCache
+    {
+        BlockCache blocks{max_cached_states};
+
+        ~StateCache()
+        {
+            is_state_cache_destroyed = true;
+        }
+    };
+
+    // per-thread free lists of shared states - a thread that submits tasks and consumes their results
+    // reuses the same few blocks instead of hitting the heap for every task
+    inline BlockCache* state_cache()
+    {
+        if (is_state_cache_destroyed)
+            return nullptr;
+
+        thread_local StateCache cache;
+        return &cache.blocks;
+    }
+
+    struct Empty
+    {
+    };
+
+    // shared by one TaskPromise and one TaskFuture - the last one to let go deletes it
+    template <typename T>
+    class TaskState
+    {
+        static_assert(!std::is_reference<T>::value, "tasks returning references are not supported");
+
+        using Value = std::conditional_t<std::is_void<T>::value, Empty, T>;
+
+        // bits of the status word
+        enum Status : uint32_t
+        {
+            ready = 1,
+            has_waiters = 2,
+            has_continuation = 4
+        };
+
+        std::atomic<uint32_t> refs_{1};
+        std::atomic<uint32_t> status_{0};
+        std::variant<std::monostate, Value, std::exception_ptr> result_;
+        Executor* executor_;
+        Task continuation_;
+        bool is_continuation_inline_{false};
+
+        // the continuation is run by whoever sets the second of the ready and has_continuation bits;
+        // has_continuation is cleared once it is moved out, so the slot can take another continuation
+        void run_continuation()
+        {
+            Task continuation = std::move(continuation_);
+            status_.fetch_and(~static_cast<uint32_t>(has_continuation), std::memory_order_release);
+
+            if (executor_ && !is_continuation_inline_)
+                executor_->execute(std::move(continuation));
+            else
+                continuation();
+        }
+
+        void make_ready()
+        {
+            const uint32_t status = status_.fetch_or(ready, std::memory_order_acq_rel);
+
+            if (status & has_waiters)
+                atomic_notify_all(status_);
+
+            if (status & has_continuation)
+                run_continuation();
+        }
+
+        // returns false when the state is ready, otherwise the status to sleep on (with has_waiters set)
+        bool announce_waiter(uint32_t& status)
+        {
+            status = status_.load(std::memory_order_acquire);
+
+            while (!(status & ready))
+            {
+                if ((status & has_waiters)
+                    || status_.compare_exchange_weak(status, status | has_waiters, std::memory_order_acquire))
+                {
+                    status |= has_waiters;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    public:
+        explicit TaskState(Executor* executor) : executor_{executor}
+        {
+        }
+
+        static void* operator new(size_t size)
+        {
+            if (BlockCache* cache = state_cache())
+                return cache->allocate(size);
+
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* ptr, size_t size) noexcept
+        {
+            if (BlockCache* cache = state_cache())
+                cache->deallocate(ptr, size);
+            else
+                ::operator delete(ptr);
+        }
+
+        Executor* executor() const
+        {
+            return executor_;
+        }
+
+        void add_ref()
+        {
+            refs_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+            if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        template <typename... Args>
+        void set_value(Args&&... args)
+        {
+            result_.template emplace<1>(std::forward<Args>(args)...);
+            make_ready();
+        }
+
+        void set_exception(std::exception_ptr e)
+        {
+            result_.template emplace<2>(std::move(e));
+            make_ready();
+        }
+
+        // at most one continuation per state - it is submitted to the executor (or run inline when is_inline is set
+        // or there is no executor) as soon as the state is ready
+        void set_continuation(Task continuation, bool is_inline)
+        {
+            assert(!(status_.load(std::memory_order_acquire) & has_continuation) && "a future has at most one continuation");
+
+            continuation_ = std::move(continuation);
+            is_continuation_inline_ = is_inline;
+
+            if (status_.fetch_or(has_continuation, std::memory_order_acq_rel) & ready)
+                run_continuation();
+        }
+
+        // removes a continuation that has not run - when the state became ready in the meantime, waits until
+        // the continuation has been moved out of the slot (it may still be running afterwards)
+        void detach_continuation()
+        {
+            uint32_t status = status_.load(std::memory_order_acquire);
+
+            while (!(status & ready))
+            {
+                if (status_.compare_exchange_weak(status, status & ~static_cast<uint32_t>(has_continuation), std::memory_order_acq_rel))
+                {
+                    continuation_ = nullptr;
+                    return;
+                }
+            }
+
+            while (status_.load(std::memory_order_acquire) & has_continuation)
+                std::this_thread::yield();
+        }
+
+        bool is_ready() const
+        {
+            return status_.load(std::memory_order_acquire) & ready;
+        }
+
+        void wait()
+        {
+            uint32_t status;
+            while (announce_waiter(status))
+                atomic_wait(status_, status);
+        }
+
+        template <typename Clock, typename Duration>
+        bool wait_until(const std::chrono::time_point<Clock, Duration>& timeout_time)
+        {
+            uint32_t status;
+            while (announce_waiter(status))
+            {
+                if (!atomic_wait_until(status_, status, timeout_time))
+                    return is_ready();
+            }
+
+            return true;
+        }
+
+        // must be called once, after the state is ready
+        Value take()
+        {
+            if (result_.index() == 2)
+                std::rethrow_exception(std::get<2>(result_));
+
+            return std::move(std::get<1>(result_));
+        }
+    };
+
+    // lets combinators register callbacks without exposing the state
+    struct FutureAccess
+    {
+        template <typename T>
+        static Executor* executor(const TaskFuture<T>& future)
+        {
+            return future.state_->executor();
+        }
+
+        // callback runs in the thread that completes the future (or here when it is ready) - it must be short
+        template <typename T>
+        static void on_ready(TaskFuture<T>& future, Task callback)
+        {
+            future.check_state();
+            future.state_->set_continuation(std::move(callback), true);
+        }
+
+        // frees the continuation slot taken by on_ready - afterwards the callback is not called
+        // (unless it is already running) and the future takes then() again
+        template <typename T>
+        static void detach(TaskFuture<T>& future)
+        {
+            future.state_->detach_continuation();
+        }
+    };
+}
+
+// Result of a task submitted to a thread pool - a lighter replacement of std::future.
+// The shared state is a single, recycled allocation with an intrusive reference count, and readiness is an atomic
+// status word, so a waiting thread sleeps on a futex instead of a mutex and condition variable.
+template <typename T>
+class TaskFuture
+{
+    using State = task_future_details::TaskState<T>;
+
+    State* state_{nullptr};
+
+    template <typename U>
+    friend class TaskPromise;
+
+    friend struct task_future_details::FutureAccess;
+
+    explicit TaskFuture(State* state) noexcept : state_{state}
+    {
+    }
+
+    void check_state() const
+    {
+        if (!state_)
+            throw std::future_error{std::future_errc::no_state};
+    }
+
+public:
+    TaskFuture() noexcept = default;
+
+    TaskFuture(const TaskFuture&) = delete;
+    TaskFuture& operator=(const TaskFuture&) = delete;
+
+    TaskFuture(TaskFuture&& other) noexcept : state_{std::exchange(other.state_, nullptr)}
+    {
+    }
+
+    TaskFuture& operator=(TaskFuture&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (state_)
+                state_->release();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~TaskFuture()
+    {
+        if (state_)
+            state_->release();
+    }
+
+    bool valid() const noexcept
+    {
+        return state_ != nullptr;
+    }
+
+    bool is_ready() const
+    {
+        check_state();
+        return state_->is_ready();
+    }
+
+    void wait() const
+    {
+        check_state();
+        state_->wait();
+    }
+
+    template <typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& timeout_time) const
+    {
+        check_state();
+        return state_->wait_until(timeout_time) ? std::future_status::ready : std::future_status::timeout;
+    }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    // waits for the result and rethrows an exception thrown by the task - the future is not valid afterwards
+    T get()
+    {
+        check_state();
+        state_->wait();
+
+        std::unique_ptr<State, void (*)(State*)> state{std::exchange(state_, nullptr), [](State* s) { s->release(); }};
+
+        if constexpr (std::is_void<T>::value)
+            state->take();
+        else
+            return state->take();
+    }
+
+    // when the result is ready, continuation(TaskFuture<T>) is submitted to the pool that runs the task
+    // (or run in the completing thread for a promise without a pool) - no thread waits in between.
+    // The continuation gets the ready future, so it decides what to do with an exception.
+    // Returns a future of the continuation's result - this future is not valid afterwards.
+    // The pool has to outlive the futures that may still schedule continuations on it.
+    template <typename Continuation>
+    auto then(Continuation&& continuation);
+};
+
+// Producer side of TaskFuture - a promise destroyed without a result breaks the future (std::future_errc::broken_promise).
+// Continuations of the future are submitted to executor (run inline when it is nullptr).
+template <typename T>
+class TaskPromise
+{
+    using State = task_future_details::TaskState<T>;
+
+    State* state_;
+    bool is_future_retrieved_{false};
+
+    State* take_state()
+    {
+        if (!state_)
+            throw std::future_error{std::future_errc::promise_already_satisfied};
+
+        return std::exchange(state_, nullptr);
+    }
+
+public:
+    explicit TaskPromise(Executor* executor = nullptr) : state_{new State{executor}}
+    {
+    }
+
+    TaskPromise(const TaskPromise&) = delete;
+    TaskPromise& operator=(const TaskPromise&) = delete;
+
+    TaskPromise(TaskPromise&& other) noexcept
+        : state_{std::exchange(other.state_, nullptr)}, is_future_retrieved_{other.is_future_retrieved_}
+    {
+    }
+
+    TaskPromise& operator=(TaskPromise&& other) noexcept
+    {
+        if (this != &other)
+        {
+            TaskPromise{std::move(*this)};
+            state_ = std::exchange(other.state_, nullptr);
+            is_future_retrieved_ = other.is_future_retrieved_;
+        }
+
+        return *this;
+    }
+
+    ~TaskPromise()
+    {
+        if (state_)
+        {
+            state_->set_exception(std::make_exception_ptr(std::future_error{std::future_errc::broken_promise}));
+            state_->release();
+        }
+    }
+
+    TaskFuture<T> get_future()
+    {
+        if (!state_)
+            throw std::future_error{std::future_errc::no_state};
+        if (is_future_retrieved_)
+            throw std::future_error{std::future_errc::future_already_retrieved};
+
+        is_future_retrieved_ = true;
+        state_->add_ref();
+
+        return TaskFuture<T>{state_};
+    }
+
+    template <typename... Args>
+    void set_value(Args&&... args)
+    {
+        State* state = take_state();
+        state->set_value(std::forward<Args>(args)...);
+        state->release();
+    }
+
+    void set_exception(std::exception_ptr e)
+    {
+        State* state = take_state();
+        state->set_exception(std::move(e));
+        state->release();
+    }
+
+    // runs a task and stores its result or exception
+    template <typename Callable, typename... Args>
+    void set_result_of(Callable& task, Args&&... args)
+    {
+        try
+        {
+            if constexpr (std::is_void<T>::value)
+            {
+                std::invoke(task, std::forward<Args>(args)...);
+                set_value();
+            }
+            else
+                set_value(std::invoke(task, std::forward<Args>(args)...));
+        }
+        catch (...)
+        {
+            set_exception(std::current_exception());
+        }
+    }
+};
+
+template <typename T>
+template <typename Continuation>
+auto TaskFuture<T>::then(Continuation&& continuation)
+{
+    using ResultT = std::invoke_result_t<std::decay_t<Continuation>&, TaskFuture<T>>;
+
+    check_state();
+
+    State* state = state_;
+    TaskPromise<ResultT> promise{state->executor()};
+    TaskFuture<ResultT> fresult = promise.get_future();
+
+    // the continuation owns this future until it runs
+    state->set_continuation(
+        [continuation = std::forward<Continuation>(continuation), promise = std::move(promise),
+            ready_future = TaskFuture{std::exchange(state_, nullptr)}]() mutable {
+            promise.set_result_of(continuation, std::move(ready_future));
+        },
+        false);
+
+    return fresult;
+}
+
+namespace task_future_details
+{
+    template <typename T>
+    void check_all_valid(const std::vector<TaskFuture<T>>& futures)
+    {
+        for (const auto& f : futures)
+        {
+            if (!f.valid())
+                throw std::future_error{std::future_errc::no_state};
+        }
+    }
+
+    template <typename T>
+    Executor* common_executor(const std::vector<TaskFuture<T>>& futures)
+    {
+        return futures.empty() ? nullptr : FutureAccess::executor(futures.front());
+    }
+}
+
+// Becomes ready when all futures are ready - yields them (ready) in the original order.
+// Nothing blocks: the last future to complete sets the result.
+template <typename T>
+TaskFuture<std::vector<TaskFuture<T>>> when_all(std::vector<TaskFuture<T>> futures)
+{
+    using Futures = std::vector<TaskFuture<T>>;
+
+    task_future_details::check_all_valid(futures);
+
+    // one extra count held until all callbacks are registered - nobody moves the futures out earlier
+    struct Context
+    {
+        Futures futures;
+        std::atomic<size_t> remaining;
+        TaskPromise<Futures> promise;
+
+        Context(Futures&& fs, Executor* executor) : futures{std::move(fs)}, remaining{futures.size() + 1}, promise{executor}
+        {
+        }
+
+        void arrive()
+        {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                promise.set_value(std::move(futures));
+        }
+    };
+
+    Executor* executor = task_future_details::common_executor(futures);
+    auto context = std::make_shared<Context>(std::move(futures), executor);
+    auto fresult = context->promise.get_future();
+
+    for (auto& f : context->futures)
+        task_future_details::FutureAccess::on_ready(f, [context] { context->arrive(); });
+
+    context->arrive();
+
+    return fresult;
+}
+
+template <typename T>
+struct WhenAnyResult
+{
+    size_t index; // index of the first ready future
+    std::vector<TaskFuture<T>> futures;
+};
+
+// Becomes ready as soon as any of the futures is ready - yields all futures and the index of the ready one.
+// An empty vector gives a ready result with index == size_t(-1).
+template <typename T>
+TaskFuture<WhenAnyResult<T>> when_any(std::vector<TaskFuture<T>> futures)
+{
+    using Futures = std::vector<TaskFuture<T>>;
+
+    task_future_details::check_all_valid(futures);
+
+    // the result is set by the second of: the first ready future, the end of registration
+    struct Context
+    {
+        Futures futures;
+        std::atomic<bool> has_winner{false};
+        size_t winner{static_cast<size_t>(-1)};
+        std::atomic<int> gate{2};
+        TaskPromise<WhenAnyResult<T>> promise;
+
+        Context(Futures&& fs, Executor* executor) : futures{std::move(fs)}, promise{executor}
+        {
+        }
+
+        // callbacks of the other futures are detached before they are handed out, so they accept then()
+        void arrive()
+        {
+            if (gate.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                for (size_t i = 0; i < futures.size(); ++i)
+                {
+                    if (i != winner)
+                        task_future_details::FutureAccess::detach(futures[i]);
+                }
+
+                promise.set_value(WhenAnyResult<T>{winner, std::move(futures)});
+            }
+        }
+    };
+
+    Executor* executor = task_future_details::common_executor(futures);
+    auto context = std::make_shared<Context>(std::move(futures), executor);
+    auto fresult = context->promise.get_future();
+
+    if (context->futures.empty())
+        context->arrive(); // nothing will be ready
+
+    for (size_t i = 0; i < context->futures.size(); ++i)
+    {
+        task_future_details::FutureAccess::on_ready(context->futures[i], [context, i] {
+            if (!context->has_winner.exchange(true, std::memory_order_acq_rel))
+            {
+                context->winner = i;
+                context->arrive();
+            }
+        });
+    }
+
+    context->arrive();
+
+    return fresult;
+}
+
+#endif // TASK_FUTURE_HPP
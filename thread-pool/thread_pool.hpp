@@ -0,0 +1,182 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "executor.hpp"
+#include "task_future.hpp"
+#include "thread_safe_queue.hpp"
+
+namespace thread_pool_details
+{
+    // bounded queues (BoundedThreadSafeQueue, MpmcQueue) have try_push
+    template <typename Queue, typename = void>
+    struct HasTryPush : std::false_type
+    {
+    };
+
+    template <typename Queue>
+    struct HasTryPush<Queue, std::void_t<decltype(std::declval<Queue&>().try_push(std::declval<Task>()))>> : std::true_type
+    {
+    };
+}
+
+// all workers pop tasks from one shared TaskQueue
+template <typename TaskQueue = ThreadSafeQueue<Task>>
+class ThreadPool : public Executor
+{
+    std::vector<std::thread> threads_;
+    TaskQueue q_tasks_;
+    std::atomic<bool> discards_pending_{false};
+
+    // pool of the current worker thread
+    static ThreadPool*& this_worker()
+    {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    void run()
+    {
+        this_worker() = this;
+
+        Task task;
+        while(q_tasks_.pop(task) == QueueStatus::success)
+        {
+            if (discards_pending_.load())
+                task = nullptr; // breaks the promise of the task
+            else
+                task();
+        }
+    }
+
+    void join_workers()
+    {
+        for(auto& thd : threads_)
+            if (thd.joinable())
+                thd.join();
+    }
+
+    // returns false when a worker of this pool would have to wait for space in a full bounded queue -
+    // the task is left in place then (also when it throws QueueClosed)
+    bool push_continuation(Task& task)
+    {
+        if constexpr (thread_pool_details::HasTryPush<TaskQueue>::value)
+        {
+            if (this_worker() == this)
+                return q_tasks_.try_push(std::move(task));
+        }
+
+        q_tasks_.push(std::move(task));
+        return true;
+    }
+
+public:
+    // extra arguments are forwarded to a queue, e.g. capacity of BoundedThreadSafeQueue<Task> or MpmcQueue<Task>
+    template <typename... QueueArgs>
+    ThreadPool(size_t size, QueueArgs&&... queue_args)
+        : threads_(size), q_tasks_(std::forward<QueueArgs>(queue_args)...)
+    {
+        for(size_t i = 0; i < size; ++i)
+            threads_[i] = std::thread{ [this] { run(); } };
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    // extra arguments are passed to a queue push, e.g. a priority level of PriorityThreadSafeQueue<Task>;
+    // a task submitted by a worker after the queue has been closed (the pool is being destroyed) runs
+    // in that worker - fork/join tasks still get their subtasks done
+    template <typename Callable, typename... PushArgs>
+    auto submit(Callable&& task, PushArgs... push_args)
+    {
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        TaskPromise<ResultT> promise{this};
+        TaskFuture<ResultT> fresult = promise.get_future();
+
+        Task wrapped_task{[task = std::forward<Callable>(task), promise = std::move(promise)]() mutable {
+            promise.set_result_of(task);
+        }};
+
+        try
+        {
+            q_tasks_.push(std::move(wrapped_task), push_args...);
+        }
+        catch (const QueueClosed&)
+        {
+            if (this_worker() != this)
+                throw;
+
+            wrapped_task();
+        }
+
+        return fresult;
+    }
+
+    // used for continuations of futures - they go to the shared queue, so any worker (or a thread waiting
+    // in run_pending_task) can run them; when a worker finds a bounded queue full or the queue is closed
+    // (shutdown) the continuation runs in the calling thread
+    void execute(Task task) override
+    {
+        try
+        {
+            if (push_continuation(task))
+                return;
+        }
+        catch (const QueueClosed&)
+        {
+        }
+
+        task();
+    }
+
+    // runs one queued task in the calling thread - lets a task wait for its subtasks without blocking a worker
+    bool run_pending_task()
+    {
+        Task task;
+        if (!q_tasks_.try_pop(task))
+            return false;
+
+        task();
+        return true;
+    }
+
+    // stops the pool after all queued tasks (and tasks they submit) are done - workers submit in place
+    // once the queue is closed
+    void shutdown()
+    {
+        // wakes all idle workers at once - workers exit when the queue is drained
+        q_tasks_.close();
+        join_workers();
+    }
+
+    // stops the pool without running queued tasks - the tasks are destroyed, so their futures get
+    // std::future_errc::broken_promise; workers finish only the tasks they are running
+    void shutdown_now()
+    {
+        discards_pending_.store(true);
+        q_tasks_.close();
+
+        Task task;
+        while (q_tasks_.try_pop(task))
+            task = nullptr;
+
+        join_workers();
+    }
+
+    // queued tasks are discarded - call shutdown() first to get them done
+    ~ThreadPool()
+    {
+        shutdown_now();
+    }
+};
+
+#endif // THREAD_POOL_HPP
@@ -1,73 +1,346 @@
 #ifndef THREAD_SAFE_QUEUE_HPP
 #define THREAD_SAFE_QUEUE_HPP
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iterator>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <utility>
+#include <vector>
 
-template <typename T>
+#include "queue_notifier.hpp"
+#include "queue_stats.hpp"
+#include "queue_status.hpp"
+#include "wait_policies.hpp"
+
+// Container can be any std::queue-compatible container, e.g. std::deque<T, RecyclingAllocator<T>>
+// to avoid heap allocations in steady state.
+// WaitPolicy (see wait_policies.hpp) decides whether pop spins before it blocks on a condition variable.
+// Stats (see queue_stats.hpp) enables instrumentation at compile time - QueueStats or NoQueueStats.
+// A QueueNotifier attached with set_notifier is signalled on every push and on close (see queue_selector.hpp).
+template <typename T, typename Container = std::deque<T>, typename WaitPolicy = BlockingWait, typename Stats = NoQueueStats>
 class ThreadSafeQueue
 {
-    std::queue<T> q_;
+    std::queue<T, Container> q_;
     std::mutex mtx_q_;
     std::condition_variable cv_q_not_empty_;
+    bool is_closed_{false};
+    size_t waiting_consumers_{0}; // consumers parked on cv_q_not_empty_ - producers signal only when it is non-zero
+    std::atomic<size_t> size_hint_{0}; // lets waiting consumers spin without taking the lock
+    QueueNotifier* notifier_{nullptr};
+    unsigned int notifier_source_{0};
+    WaitPolicy wait_policy_;
+    Stats stats_;
+
+    std::unique_lock<std::mutex> lock_queue()
+    {
+        if (!Stats::is_enabled)
+            return std::unique_lock<std::mutex>{mtx_q_};
+
+        std::unique_lock<std::mutex> lk{mtx_q_, std::try_to_lock};
+        if (!lk.owns_lock())
+        {
+            stats_.on_lock_contended();
+            lk.lock();
+        }
+
+        return lk;
+    }
+
+    // must be called with mtx_q_ locked
+    template <typename... Args>
+    void emplace_back(Args&&... args)
+    {
+        q_.emplace(std::forward<Args>(args)...);
+        stats_.on_push(q_.size());
+    }
+
+    template <typename... Args>
+    void push_one(Args&&... args)
+    {
+        size_t to_wake;
+        {
+            auto lk = lock_queue();
+            throw_if_closed();
+            emplace_back(std::forward<Args>(args)...);
+            update_size_hint();
+            to_wake = consumers_to_wake(1);
+            signal_notifier();
+        }
+        notify_consumers(to_wake);
+    }
+
+    // must be called with mtx_q_ locked
+    void drop_front()
+    {
+        q_.pop();
+        stats_.on_pop(q_.size());
+    }
+
+    void update_size_hint()
+    {
+        size_hint_.store(q_.size(), std::memory_order_release);
+    }
+
+    // must be called with mtx_q_ locked
+    template <typename Wait>
+    auto wait_as_consumer(Wait wait)
+    {
+        const auto start = Stats::is_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+        ++waiting_consumers_;
+        auto result = wait();
+        --waiting_consumers_;
+
+        if (Stats::is_enabled)
+            stats_.on_consumer_blocked(std::chrono::steady_clock::now() - start);
+
+        return result;
+    }
+
+    std::unique_lock<std::mutex> lock_when_ready_to_pop()
+    {
+        wait_policy_.spin([this] { return size_hint_.load(std::memory_order_acquire) != 0; });
+
+        auto lk = lock_queue();
+        if (!is_ready_to_pop())
+        {
+            wait_policy_.park([&] {
+                wait_as_consumer([&] {
+                    cv_q_not_empty_.wait(lk, [this] { return is_ready_to_pop(); });
+                    return true;
+                });
+            });
+        }
+
+        return lk;
+    }
+
+    // must be called with mtx_q_ locked
+    size_t consumers_to_wake(size_t no_of_pushed_items) const
+    {
+        return no_of_pushed_items < waiting_consumers_ ? no_of_pushed_items : waiting_consumers_;
+    }
+
+    // must be called with mtx_q_ locked - the lock keeps the notifier attached until it is signalled
+    void signal_notifier()
+    {
+        if (notifier_)
+            notifier_->notify(notifier_source_);
+    }
+
+    void notify_consumers(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            cv_q_not_empty_.notify_one();
+    }
+
+    void throw_if_closed() const
+    {
+        if (is_closed_)
+            throw QueueClosed{};
+    }
+
+    bool is_ready_to_pop() const
+    {
+        return !q_.empty() || is_closed_;
+    }
+
+    QueueStatus pop_front(T& item)
+    {
+        if (q_.empty())
+            return QueueStatus::closed;
+
+        item = std::move(q_.front());
+        drop_front();
+        update_size_hint();
+
+        return QueueStatus::success;
+    }
+
+    std::optional<T> take_front()
+    {
+        if (q_.empty())
+            return std::nullopt;
+
+        std::optional<T> item{std::move(q_.front())};
+        drop_front();
+        update_size_hint();
+
+        return item;
+    }
+
 public:
     ThreadSafeQueue() = default;
 
+    explicit ThreadSafeQueue(const WaitPolicy& wait_policy) : wait_policy_{wait_policy}
+    {
+    }
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
     bool empty()
     {
         std::lock_guard<std::mutex> lk{mtx_q_};
         return q_.empty();
     }
 
-    void push(const T& item)
+    // wakes all blocked consumers - items already in the queue can still be popped,
+    // pushing new items throws QueueClosed
+    void close()
     {
+        bool has_waiting_consumers;
         {
             std::lock_guard<std::mutex> lk{mtx_q_};
-            q_.push(item);
+            is_closed_ = true;
+            has_waiting_consumers = waiting_consumers_ > 0;
+            signal_notifier();
         }
-        cv_q_not_empty_.notify_one();
+
+        if (has_waiting_consumers)
+            cv_q_not_empty_.notify_all();
+    }
+
+    bool is_closed()
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        return is_closed_;
+    }
+
+    // source identifies this queue for the notifier - pass nullptr to detach (the notifier must outlive its attachment)
+    void set_notifier(QueueNotifier* notifier, unsigned int source = 0)
+    {
+        std::lock_guard<std::mutex> lk{mtx_q_};
+        notifier_ = notifier;
+        notifier_source_ = source;
+    }
+
+    void push(const T& item)
+    {
+        push_one(item);
     }
 
     void push(T&& item)
     {
-        {
-            std::lock_guard<std::mutex> lk{mtx_q_};
-            q_.push(std::move(item));
-        }
-        cv_q_not_empty_.notify_one();
+        push_one(std::move(item));
+    }
+
+    // constructs an item in place from args
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        push_one(std::forward<Args>(args)...);
     }
 
+    // items are copied (std::initializer_list gives only const access) - use emplace or push_bulk to avoid copies
     void push(std::initializer_list<T> items)
     {
+        push_range(items.begin(), items.end());
+    }
+
+    // items are copied - pass std::move_iterator-s to move them into the queue
+    template <typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        size_t to_wake;
         {
-            std::lock_guard<std::mutex> lk{mtx_q_};
-            for(const auto& item : items)
-                q_.push(item);
+            auto lk = lock_queue();
+            throw_if_closed();
+            size_t count = 0;
+            for(; first != last; ++first, ++count)
+                emplace_back(*first);
+            update_size_hint();
+            to_wake = consumers_to_wake(count);
+            if (count > 0)
+                signal_notifier();
         }
-        cv_q_not_empty_.notify_all();
+        notify_consumers(to_wake);
+    }
+
+    void push_bulk(std::vector<T>&& items)
+    {
+        push_range(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+        items.clear();
     }
 
+    // returns false only when the queue is empty
     bool try_pop(T& item)
     {
-        std::unique_lock<std::mutex> lk{mtx_q_, std::try_to_lock};
+        auto lk = lock_queue();
 
-        if (!lk.owns_lock() || q_.empty())
-            return false;
+        return pop_front(item) == QueueStatus::success;
+    }
 
-        item = std::move(q_.front());
-        q_.pop();
+    // returns std::nullopt only when the queue is empty - T does not have to be default-constructible
+    std::optional<T> try_pop()
+    {
+        auto lk = lock_queue();
 
-        return true;
+        return take_front();
     }
 
-    void pop(T& item)
+    QueueStatus pop(T& item)
     {
-        std::unique_lock<std::mutex> lk{mtx_q_};
-        cv_q_not_empty_.wait(lk, [this] { return !q_.empty(); });
+        auto lk = lock_when_ready_to_pop();
 
-        item = std::move(q_.front());
-        q_.pop();
+        return pop_front(item);
+    }
+
+    // returns std::nullopt when the queue is closed and empty - T does not have to be default-constructible
+    std::optional<T> pop()
+    {
+        auto lk = lock_when_ready_to_pop();
+
+        return take_front();
+    }
+
+    template <typename Clock, typename Duration>
+    QueueStatus pop_until(T& item, const std::chrono::time_point<Clock, Duration>& timeout_time)
+    {
+        auto lk = lock_queue();
+        bool is_ready = is_ready_to_pop() || wait_as_consumer([&] {
+            return cv_q_not_empty_.wait_until(lk, timeout_time, [this] { return is_ready_to_pop(); });
+        });
+
+        if (!is_ready)
+            return QueueStatus::timeout;
+
+        return pop_front(item);
+    }
+
+    template <typename Rep, typename Period>
+    QueueStatus pop_for(T& item, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return pop_until(item, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // waits for at least one item and then drains up to max_n items - returns number of popped items
+    // (0 only when the queue is closed and empty)
+    template <typename OutputIt>
+    size_t pop_bulk(OutputIt out, size_t max_n)
+    {
+        if (max_n == 0)
+            return 0;
+
+        auto lk = lock_when_ready_to_pop();
+
+        size_t count = 0;
+        for(; count < max_n && !q_.empty(); ++count)
+        {
+            *out++ = std::move(q_.front());
+            drop_front();
+        }
+        update_size_hint();
+
+        return count;
     }
 };
 
@@ -0,0 +1,189 @@
+#ifndef UNIQUE_FUNCTION_HPP
+#define UNIQUE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t BufferSize = 64>
+class UniqueFunction;
+
+// Move-only replacement of std::function - can hold move-only callables (e.g. a lambda owning a packaged_task)
+// and stores callables of up to BufferSize bytes in place, so typical tasks are wrapped without a heap allocation.
+// Bigger callables (or ones that may throw when moved) are stored on the heap.
+template <typename R, typename... Args, size_t BufferSize>
+class UniqueFunction<R(Args...), BufferSize>
+{
+    using Storage = std::aligned_storage_t<BufferSize, alignof(std::max_align_t)>;
+
+    // hand-made vtable - one static instance per stored type
+    struct Operations
+    {
+        R (*invoke)(Storage& storage, Args&&... args);
+        void (*move)(Storage& from, Storage& to) noexcept; // move-constructs into to and destroys from
+        void (*destroy)(Storage& storage) noexcept;
+    };
+
+    template <typename F>
+    static constexpr bool is_stored_locally = sizeof(F) <= sizeof(Storage) && alignof(F) <= alignof(Storage)
+        && std::is_nothrow_move_constructible<F>::value;
+
+    template <typename F, bool IsLocal = is_stored_locally<F>>
+    struct Manager
+    {
+        static F& target(Storage& storage)
+        {
+            return *std::launder(reinterpret_cast<F*>(&storage));
+        }
+
+        template <typename G>
+        static void create(Storage& storage, G&& f)
+        {
+            new (&storage) F(std::forward<G>(f));
+        }
+
+        static void move(Storage& from, Storage& to) noexcept
+        {
+            new (&to) F(std::move(target(from)));
+            target(from).~F();
+        }
+
+        static void destroy(Storage& storage) noexcept
+        {
+            target(storage).~F();
+        }
+    };
+
+    // the storage holds an owning pointer
+    template <typename F>
+    struct Manager<F, false>
+    {
+        static F*& pointer(Storage& storage)
+        {
+            return *std::launder(reinterpret_cast<F**>(&storage));
+        }
+
+        static F& target(Storage& storage)
+        {
+            return *pointer(storage);
+        }
+
+        template <typename G>
+        static void create(Storage& storage, G&& f)
+        {
+            new (&storage) F*(new F(std::forward<G>(f)));
+        }
+
+        static void move(Storage& from, Storage& to) noexcept
+        {
+            new (&to) F*(pointer(from));
+        }
+
+        static void destroy(Storage& storage) noexcept
+        {
+            delete pointer(storage);
+        }
+    };
+
+    template <typename F>
+    static R invoke(Storage& storage, Args&&... args)
+    {
+        if constexpr (std::is_void<R>::value)
+            std::invoke(Manager<F>::target(storage), std::forward<Args>(args)...);
+        else
+            return std::invoke(Manager<F>::target(storage), std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static constexpr Operations operations_for{&invoke<F>, &Manager<F>::move, &Manager<F>::destroy};
+
+    Storage storage_;
+    const Operations* ops_{nullptr};
+
+    void reset() noexcept
+    {
+        if (ops_)
+        {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+public:
+    UniqueFunction() noexcept = default;
+
+    UniqueFunction(std::nullptr_t) noexcept
+    {
+    }
+
+    template <typename Callable, typename F = std::decay_t<Callable>,
+        typename = std::enable_if_t<!std::is_same<F, UniqueFunction>::value && std::is_invocable_r<R, F&, Args...>::value>>
+    UniqueFunction(Callable&& f)
+    {
+        Manager<F>::create(storage_, std::forward<Callable>(f));
+        ops_ = &operations_for<F>;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    UniqueFunction(UniqueFunction&& other) noexcept : ops_{other.ops_}
+    {
+        if (ops_)
+        {
+            ops_->move(other.storage_, storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.ops_)
+            {
+                other.ops_->move(other.storage_, storage_);
+                ops_ = std::exchange(other.ops_, nullptr);
+            }
+        }
+
+        return *this;
+    }
+
+    UniqueFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~UniqueFunction()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    // true when a callable of type F is stored without a heap allocation
+    template <typename F>
+    static constexpr bool fits_small_buffer()
+    {
+        return is_stored_locally<std::decay_t<F>>;
+    }
+
+    R operator()(Args... args)
+    {
+        if (!ops_)
+            throw std::bad_function_call{};
+
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+};
+
+#endif // UNIQUE_FUNCTION_HPP
@@ -0,0 +1,270 @@
+#ifndef WORK_STEALING_THREAD_POOL_HPP
+#define WORK_STEALING_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "chase_lev_deque.hpp"
+#include "executor.hpp"
+#include "task_future.hpp"
+#include "thread_safe_queue.hpp"
+
+// Every worker owns a Chase-Lev deque - tasks submitted by a worker go to its own deque and are run LIFO
+// (good cache locality for fork/join), idle workers steal FIFO (the oldest, usually biggest, tasks)
+// from random victims. Tasks submitted from outside the pool go through a shared injection queue.
+class WorkStealingThreadPool : public Executor
+{
+    // deques hold raw pointers - a task pushed by a worker lives in a node recycled through the per-thread
+    // block cache of shared states: the worker (or a thief, which submits tasks too) reuses freed nodes
+    struct TaskNode
+    {
+        Task task;
+
+        static void* operator new(size_t size)
+        {
+            if (BlockCache* cache = task_future_details::state_cache())
+                return cache->allocate(size);
+
+            return ::operator new(size);
+        }
+
+        static void operator delete(void* ptr, size_t size) noexcept
+        {
+            if (BlockCache* cache = task_future_details::state_cache())
+                cache->deallocate(ptr, size);
+            else
+                ::operator delete(ptr);
+        }
+    };
+
+    using TaskPtr = TaskNode*;
+
+    struct Worker
+    {
+        ChaseLevDeque<TaskPtr> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    ThreadSafeQueue<Task> injection_queue_;
+
+    // idle workers park until new work is signalled - a submit wakes one parked worker
+    std::atomic<uint64_t> work_epoch_{0};
+    std::atomic<int> sleeping_workers_{0};
+    std::atomic<bool> is_stopping_{false};
+    std::mutex mtx_idle_;
+    std::condition_variable cv_work_;
+
+    struct WorkerContext
+    {
+        WorkStealingThreadPool* pool;
+        size_t index;
+    };
+
+    static WorkerContext& this_worker()
+    {
+        thread_local WorkerContext context{nullptr, 0};
+        return context;
+    }
+
+    static size_t random_victim(size_t no_of_workers)
+    {
+        // xorshift - cheap per-thread pseudo random numbers
+        thread_local uint64_t state = std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<size_t>(state % no_of_workers);
+    }
+
+    Worker* local_worker() const
+    {
+        const WorkerContext& context = this_worker();
+        return context.pool == this ? workers_[context.index].get() : nullptr;
+    }
+
+    void signal_work()
+    {
+        work_epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+        if (sleeping_workers_.load(std::memory_order_seq_cst) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk{mtx_idle_};
+            }
+            cv_work_.notify_one();
+        }
+    }
+
+    void wait_for_work(uint64_t seen_epoch)
+    {
+        std::unique_lock<std::mutex> lk{mtx_idle_};
+
+        sleeping_workers_.fetch_add(1, std::memory_order_seq_cst);
+        cv_work_.wait(lk, [&] {
+            return work_epoch_.load(std::memory_order_seq_cst) != seen_epoch || is_stopping_.load();
+        });
+        sleeping_workers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static void take(TaskPtr node, Task& task)
+    {
+        task = std::move(node->task);
+        delete node;
+    }
+
+    bool steal(size_t thief_index, Task& task)
+    {
+        const size_t no_of_workers = workers_.size();
+        const size_t start = random_victim(no_of_workers);
+
+        for (size_t i = 0; i < no_of_workers; ++i)
+        {
+            const size_t victim = (start + i) % no_of_workers;
+            if (victim == thief_index)
+                continue;
+
+            if (auto node = workers_[victim]->tasks.steal())
+            {
+                take(*node, task);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // local deque first, then the injection queue, then other workers
+    bool find_task(Worker* worker, size_t index, Task& task)
+    {
+        if (worker)
+        {
+            if (auto node = worker->tasks.pop())
+            {
+                take(*node, task);
+                return true;
+            }
+        }
+
+        if (injection_queue_.try_pop(task))
+            return true;
+
+        return steal(index, task);
+    }
+
+    void worker_loop(size_t index)
+    {
+        this_worker() = WorkerContext{this, index};
+        Worker* worker = workers_[index].get();
+        Task task;
+
+        while (true)
+        {
+            const uint64_t epoch = work_epoch_.load(std::memory_order_seq_cst);
+
+            if (find_task(worker, index, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            if (is_stopping_.load())
+                return;
+
+            wait_for_work(epoch);
+        }
+    }
+
+    void push_task(Task&& task)
+    {
+        if (Worker* worker = local_worker())
+        {
+            std::unique_ptr<TaskNode> node{new TaskNode{std::move(task)}};
+            worker->tasks.push(node.get());
+            node.release();
+        }
+        else
+            injection_queue_.push(std::move(task));
+
+        signal_work();
+    }
+
+public:
+    explicit WorkStealingThreadPool(size_t size = std::max(std::thread::hardware_concurrency(), 1u))
+    {
+        for (size_t i = 0; i < size; ++i)
+            workers_.push_back(std::make_unique<Worker>());
+
+        for (size_t i = 0; i < size; ++i)
+            workers_[i]->thread = std::thread{[this, i] { worker_loop(i); }};
+    }
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    // workers finish all submitted tasks (including tasks submitted by tasks) before they exit
+    ~WorkStealingThreadPool()
+    {
+        is_stopping_.store(true);
+        {
+            std::lock_guard<std::mutex> lk{mtx_idle_};
+        }
+        cv_work_.notify_all();
+
+        for (auto& worker : workers_)
+            worker->thread.join();
+    }
+
+    size_t size() const
+    {
+        return workers_.size();
+    }
+
+    template <typename Callable>
+    auto submit(Callable&& task)
+    {
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        TaskPromise<ResultT> promise{this};
+        TaskFuture<ResultT> fresult = promise.get_future();
+
+        push_task(Task{[task = std::forward<Callable>(task), promise = std::move(promise)]() mutable {
+            promise.set_result_of(task);
+        }});
+
+        return fresult;
+    }
+
+    // used for continuations of futures
+    void execute(Task task) override
+    {
+        push_task(std::move(task));
+    }
+
+    // runs one pending task in the calling thread - a task waiting for its subtasks should call it in a loop
+    // instead of blocking a worker
+    bool run_pending_task()
+    {
+        const WorkerContext& context = this_worker();
+        const size_t index = context.pool == this ? context.index : workers_.size();
+
+        Task task;
+        if (!find_task(local_worker(), index, task))
+            return false;
+
+        task();
+        return true;
+    }
+};
+
+#endif // WORK_STEALING_THREAD_POOL_HPP